@@ -93,6 +93,10 @@ void help(char **token)
             "\t- Without <flag>/<count>, top 15 records by default\n"
             "\t- <count> indicates the number of record to view\n"
             "\tflag: all, to view all records\n"
+            "\tflag: next, to view the next page (older records)\n"
+            "\tflag: prev, to view the previous page (newer records)\n"
+            "\t- FORMAT: view from <date>/<id>\n"
+            "\t- to view a page from the given date (yyyy-mm-dd) or record id\n"
         "\nfilter\n"
             "\t- to view records based on the given range values\n"
             "\t- FORMAT: filter <flag> <min_value> <max_value> <in/ex>\n"
@@ -103,9 +107,61 @@ void help(char **token)
             "\tflag: date, to apply filter based on date values\n"
                 "\t\t- dot(.) is used to ignore either <min_value> or <max_value>\n"
                 "\t\t- dot(.) cannot be used for both <min_value> and <max_value>\n"
+                "\t\t- FORMAT: filter date <min_value> <max_value> --totals\n"
+                "\t\t- with --totals, only the totals of the range are shown\n"
+            "\t- FORMAT: filter <expression>\n"
+            "\t- to combine the terms of date, amount, in/ex, entity, comment\n"
+                "\t\t- terms: date <min> <max>, amount <min> <max>, in, ex,\n"
+                "\t\t         entity <text>, comment <text>, ( <expression> )\n"
+                "\t\t- terms are joined by 'and' (default) or 'or'\n"
+                "\t\t- entity and comment terms match the records containing <text>\n"
+                "\t\t- eg: filter date 2024-01-01 2024-03-31 ex amount 500 . entity rent\n"
+            "\t- FORMAT: filter <expression> limit <n> offset <m>\n"
+                "\t\t- to show <n> records, after skipping <m> records\n"
+                "\t\t- both are optional, totals are of the records shown\n"
+        "\nsummary\n"
+            "\t- to view the totals of every year or month\n"
+            "\t- FORMAT: summary <year>/<month>\n"
+            "\t- Without <year>/<month>, totals of every year\n"
+            "\t- <year> (yyyy), totals of every month of the year\n"
+            "\t- <month> (yyyy-mm), totals of the month\n"
+        "\ngroup\n"
+            "\t- to view the totals of every entity, month, year or type\n"
+            "\t- FORMAT: group by <entity/month/year/type> <expression>\n"
+            "\t- <expression> is optional, same as the filter expression\n"
+            "\t- only the records matching <expression> are grouped\n"
+        "\ntop\n"
+            "\t- to view the records of largest amount\n"
+            "\t- FORMAT: top <k> <in/ex> <min_date> <max_date>\n"
+            "\t- <in/ex> and <min_date> <max_date> are optional\n"
+            "\t- dot(.) is used to ignore either <min_date> or <max_date>\n"
+        "\nquery\n"
+            "\t- to filter the records of a saved file, without opening it\n"
+            "\t- FORMAT: query <file_name> <expression>\n"
+            "\t- <expression> is same as the filter expression\n"
+            "\t- records are read from the file, memory does not grow with it\n"
+            "\t- but the changes in its journal (.jnl) are all loaded in memory\n"
+        "\nexport\n"
+            "\t- to write the records into a new csv or ndjson file\n"
+            "\t- FORMAT: export <csv/ndjson> <path> <expression>\n"
+            "\t- <expression> is optional, same as the filter expression\n"
+            "\t- records are written from the oldest, existing file is not replaced\n"
+            "\t- csv columns: id,type,amount,date,entity,comment\n"
+        "\nimport\n"
+            "\t- to add the records of a csv file (columns same as export)\n"
+            "\t- FORMAT: import <path>\n"
+            "\t- type is income/in or expense/ex, id column is not used\n"
+            "\t- records are added only if all the records are valid\n"
+        "\nsearch\n"
+            "\t- to search a text within entity or comment of records\n"
+            "\t- FORMAT: search [entity/comment] <text>\n"
+            "\t- Without entity/comment, text is searched in both\n"
+            "\t- records are shown from the latest added record\n"
         "\ninfo\n"
             "\t- to show the meta data of current inex file\n"
-            "\t- FORMAT: info\n"
+            "\t- FORMAT: info [verify]\n"
+            "\t- verify, to check the totals against all the records\n"
+            "\t- verify also shows the scan kernel in use (avx2, sse4.2 or scalar)\n"
         "\nsave\n"
             "\t- to save the current inex file\n"
             "\t- FORMAT: save\n"
@@ -0,0 +1,233 @@
+/*
+ * parseBench.c
+ *
+ * Microbenchmark of the date and amount parsers (parseStringToDate and
+ * parseStringToAmount) against the earlier sscanf based parsers,
+ * which are kept here only for the comparison
+ *
+ * Usage: parseBench [no of inputs]
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: deepaks
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "../headers/recordFunction.h"
+
+#define DEFAULT_INPUTS  2000000
+#define TEXT_LEN        16
+
+
+static int sscanfDate(const char *str, Date *date);
+static int sscanfAmount(const char *str, long *amount);
+static int isValidStringAmount(const char *str);
+static unsigned int nextRandom(unsigned int *seed);
+static double elapsedNs(const struct timespec *start, const struct timespec *end);
+
+
+int main(int argc, char *argv[])
+{
+    struct timespec start, end;
+    char (*date_text)[TEXT_LEN];
+    char (*amount_text)[TEXT_LEN];
+    unsigned int seed = 2026;
+    long amount, old_amount, sum;
+    Date date, old_date;
+    double old_ns, new_ns;
+    int count = DEFAULT_INPUTS;
+    int index;
+
+    if (argc > 1)
+        count = atoi(argv[1]);
+
+    if (count <= 0) {
+        fprintf(stderr, "Usage: %s [no of inputs]\n", argv[0]);
+        return 1;
+    }
+
+    date_text   = malloc(count * sizeof(*date_text));
+    amount_text = malloc(count * sizeof(*amount_text));
+
+    if (date_text == NULL || amount_text == NULL) {
+        fprintf(stderr, "memory allocation error\n");
+        return 1;
+    }
+
+    /* valid inputs, as they are read by the import and the console */
+    for (index = 0; index < count; index++) {
+        snprintf(date_text[index], TEXT_LEN, "%04u-%02u-%02u",
+            2000 + nextRandom(&seed) % 40, 1 + nextRandom(&seed) % 12,
+            1 + nextRandom(&seed) % 28);
+
+        if (nextRandom(&seed) % 2) {
+            snprintf(amount_text[index], TEXT_LEN, "%u.%02u",
+                nextRandom(&seed) % 1000000, nextRandom(&seed) % 100);
+        } else {
+            snprintf(amount_text[index], TEXT_LEN, "%u",
+                nextRandom(&seed) % 1000000);
+        }
+    }
+
+    /* both the parsers should give the same value */
+    for (index = 0; index < count; index++) {
+        if (parseStringToDate(date_text[index], &date) != 0
+                || sscanfDate(date_text[index], &old_date) != 0
+                || date.year != old_date.year || date.month != old_date.month
+                || date.day != old_date.day
+                || parseStringToAmount(amount_text[index], &amount) != 0
+                || sscanfAmount(amount_text[index], &old_amount) != 0
+                || amount != old_amount) {
+            fprintf(stderr, "parsers are not matching: %s %s\n",
+                date_text[index], amount_text[index]);
+            return 1;
+        }
+    }
+
+    printf("inputs : %d\n", count);
+
+    /* date */
+    sum = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (index = 0; index < count; index++) {
+        sscanfDate(date_text[index], &date);
+        sum += date.day;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    old_ns = elapsedNs(&start, &end) / count;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (index = 0; index < count; index++) {
+        parseStringToDate(date_text[index], &date);
+        sum += date.day;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    new_ns = elapsedNs(&start, &end) / count;
+
+    printf("date   : sscanf %7.1f ns, parser %7.1f ns (%.1fx)  [%ld]\n",
+        old_ns, new_ns, old_ns / new_ns, sum);
+
+    /* amount */
+    sum = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (index = 0; index < count; index++) {
+        sscanfAmount(amount_text[index], &amount);
+        sum += amount;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    old_ns = elapsedNs(&start, &end) / count;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (index = 0; index < count; index++) {
+        parseStringToAmount(amount_text[index], &amount);
+        sum += amount;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    new_ns = elapsedNs(&start, &end) / count;
+
+    printf("amount : sscanf %7.1f ns, parser %7.1f ns (%.1fx)  [%ld]\n",
+        old_ns, new_ns, old_ns / new_ns, sum);
+
+    free(date_text);
+    free(amount_text);
+
+    return 0;
+}
+
+
+/*
+ * Earlier parser of the date (yyyy-mm-dd) with sscanf
+ */
+static int sscanfDate(const char *str, Date *date)
+{
+    if (str == NULL || date == NULL)
+        return -1;
+
+    if (sscanf(str, "%d-%d-%d", &date->year, &date->month, &date->day) == 3) {
+        if (isValidDate(date)) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+
+/*
+ * Earlier parser of the amount with a validation pass and sscanf
+ */
+static int sscanfAmount(const char *str, long *amount)
+{
+    long temp_main = 0;
+    long temp_deci = 0;
+
+    if (str == NULL || amount == NULL)
+        return -1;
+
+    if (isValidStringAmount(str) == 0)
+        return 1;
+
+    if (sscanf(str, "%ld.%ld", &temp_main, &temp_deci) <= 0)
+        return 2;
+
+    if (temp_main < 0 || temp_main > 999999999999 ||
+            temp_deci < 0 || temp_deci > 99)
+        return 3;
+
+    *amount = (temp_main * 100) + temp_deci;
+
+    return 0;
+}
+
+
+static int isValidStringAmount(const char *str)
+{
+    int i, point = 0, pos = 0;
+
+    if (str == NULL)
+        return 0;
+
+    for (i = 0; str[i] != '\0'; i++) {
+        if (i >= 15)
+            return 0;
+
+        if (str[i] >= '0' && str[i] <= '9')
+            continue;
+
+        if (str[i] == '.') {
+            point++;
+
+            if (point > 1)
+                return 0;
+
+            pos = i;
+            continue;
+        }
+
+        return 0;
+    }
+
+    if (point && (i - pos) != 3)
+        return 0;
+
+    return 1;
+}
+
+
+/*
+ * Linear congruential generator, so that every run has the same inputs
+ */
+static unsigned int nextRandom(unsigned int *seed)
+{
+    *seed = *seed * 1103515245u + 12345u;
+
+    return *seed >> 8;
+}
+
+
+static double elapsedNs(const struct timespec *start, const struct timespec *end)
+{
+    return (end->tv_sec - start->tv_sec) * 1e9 + (end->tv_nsec - start->tv_nsec);
+}
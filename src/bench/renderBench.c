@@ -0,0 +1,157 @@
+/*
+ * renderBench.c
+ *
+ * Benchmark of the record listing (printRecordInConsole into the render
+ * buffer) against the earlier printf based row printer, which is kept
+ * here only for the comparison
+ *
+ * rows are written to stdout and the results to stderr,
+ * Usage: renderBench [no of rows] > /dev/null
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: deepaks
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../headers/recordFunction.h"
+
+#define DEFAULT_ROWS    1000000
+
+
+static int printfRecord(const Record *rec);
+static void printfComment(const char *comment);
+static unsigned int nextRandom(unsigned int *seed);
+static double elapsedSec(const struct timespec *start, const struct timespec *end);
+
+
+static const char *row_seperator_text =
+    "-----|-----------------|------------|---------------------------------|";
+
+
+int main(int argc, char *argv[])
+{
+    struct timespec start, end;
+    unsigned int seed = 2026;
+    double old_sec, new_sec;
+    Record *rec;
+    int count = DEFAULT_ROWS;
+    int index;
+
+    if (argc > 1)
+        count = atoi(argv[1]);
+
+    if (count <= 0) {
+        fprintf(stderr, "Usage: %s [no of rows] > /dev/null\n", argv[0]);
+        return 1;
+    }
+
+    rec = calloc(count, sizeof(*rec));
+    if (rec == NULL) {
+        fprintf(stderr, "memory allocation error\n");
+        return 1;
+    }
+
+    /* records like the ones of a ledger, comment of 0 to 120 characters */
+    for (index = 0; index < count; index++) {
+        rec[index].r_id         = index + 1;
+        rec[index].r_info       = nextRandom(&seed) % 2;
+        rec[index].r_amount     = nextRandom(&seed) % 100000000;
+        rec[index].r_date.year  = 2000 + nextRandom(&seed) % 40;
+        rec[index].r_date.month = 1 + nextRandom(&seed) % 12;
+        rec[index].r_date.day   = 1 + nextRandom(&seed) % 28;
+        snprintf(rec[index].r_entity, ENTITY_LEN, "entity %u",
+            nextRandom(&seed) % 1000);
+        memset(rec[index].r_comment, 'c', nextRandom(&seed) % 121);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (index = 0; index < count; index++)
+        printfRecord(&rec[index]);
+    fflush(stdout);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    old_sec = elapsedSec(&start, &end);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (index = 0; index < count; index++)
+        printRecordInConsole(&rec[index]);
+    flushRecordsInConsole();
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    new_sec = elapsedSec(&start, &end);
+
+    fprintf(stderr, "rows   : %d\n", count);
+    fprintf(stderr, "printf : %.2f M rows/s\n", count / old_sec / 1e6);
+    fprintf(stderr, "render : %.2f M rows/s (%.1fx)\n",
+        count / new_sec / 1e6, old_sec / new_sec);
+
+    free(rec);
+
+    return 0;
+}
+
+
+/*
+ * Earlier printer of a record row, with stdio calls for every field
+ * and every character of the comment
+ */
+static int printfRecord(const Record *rec)
+{
+    static char type[4];
+
+    if (rec == NULL)
+        return -1;
+
+    strcpy(type, " x ");
+
+    if (rec->r_info & 1)
+        strcpy(type, "+IN");
+
+    printf(" %3s | %12ld.%02ld | %04d-%02d-%02d | %s\n\n"
+        , type, (rec->r_amount / 100), (rec->r_amount % 100)
+        , rec->r_date.year, rec->r_date.month, rec->r_date.day
+        , rec->r_entity);
+
+    printf("     ID      : %d\n", rec->r_id);
+    printf("     COMMENT : ");
+    printfComment(rec->r_comment);
+    printf("\n\n%s\n", row_seperator_text);
+
+    return 0;
+}
+
+
+static void printfComment(const char *comment)
+{
+    int index = 0;
+    static const char *blank_space =
+        "\n               ";
+
+    while (comment[index] != '\0') {
+        if (index % 54 == 0 && index != 0)
+            printf("%s", blank_space);
+
+        printf("%c", comment[index]);
+
+        index++;
+    }
+}
+
+
+/*
+ * Linear congruential generator, so that every run has the same records
+ */
+static unsigned int nextRandom(unsigned int *seed)
+{
+    *seed = *seed * 1103515245u + 12345u;
+
+    return *seed >> 8;
+}
+
+
+static double elapsedSec(const struct timespec *start, const struct timespec *end)
+{
+    return (end->tv_sec - start->tv_sec) + (end->tv_nsec - start->tv_nsec) / 1e9;
+}
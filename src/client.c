@@ -6,23 +6,73 @@
  */
 
 #include <stdio.h>
+#include <string.h>
 
 #include "headers/appInfo.h"
 #include "headers/command.h"
 
 
+static int setOptions(AppDataPtr appData, int argc, char *argv[]);
+
+
 int main(int argc, char *argv[]) 
 {
     AppDataPtr appData = createAppData();
     int returnCode = 1;
 
+    if (appData == NULL)
+        return 1;
+
+    if (setOptions(appData, argc, argv) != 0) {
+        puts("\tUSAGE: ./program [-b <backup_interval_in_seconds>] [-t <scan_threads>]");
+        destroyAppData(appData);
+        return 1;
+    }
+
     app_header();
 
     while (returnCode) {
         returnCode = performGetCommand(appData);
+
+        /* backup is written in background, if it is the time */
+        createTemporaryBackup(appData);
     }
     
     destroyAppData(appData);
 
     return 0;
-} 
\ No newline at end of file
+} 
+
+
+/*
+ * Function to set the application options from the program arguments
+ * -b <seconds>, interval of the temporary backup (0 to disable)
+ * -t <threads>, no of threads to scan the records (1 to disable workers)
+ */
+static int setOptions(AppDataPtr appData, int argc, char *argv[])
+{
+    int index, value;
+    char ch;
+
+    for (index = 1; index < argc; index++) {
+        if (strcmp(argv[index], "-b") == 0 && index + 1 < argc) {
+            if (sscanf(argv[++index], "%d%c", &value, &ch) != 1 || value < 0)
+                return 1;
+
+            setBackupInterval(appData, value);
+            continue;
+        }
+
+        if (strcmp(argv[index], "-t") == 0 && index + 1 < argc) {
+            if (sscanf(argv[++index], "%d%c", &value, &ch) != 1
+                    || setScanThreads(appData, value) != 0)
+                return 1;
+
+            continue;
+        }
+
+        return 1;
+    }
+
+    return 0;
+}
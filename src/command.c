@@ -10,6 +10,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 #include "headers/command.h"
 #include "headers/consoleInput.h"
@@ -17,9 +18,14 @@
 #include "headers/inexData.h"
 #include "headers/recordFunction.h"
 #include "headers/appInfo.h"
+#include "headers/workerPool.h"
+#include "headers/scanKernel.h"
 
 #define CMD_LEN         256
-#define MAX_TOKEN       10 
+#define MAX_TOKEN       32 
+
+/* default interval (in seconds) for the temporary backup */
+#define BACKUP_INTERVAL 300
 
 /* Function pointer definition for wrapper functions */
 typedef int (*CommandFunction)(AppDataPtr appData);
@@ -36,6 +42,9 @@ struct appData {
     char            *cmd;
     char            **token;
     int             saved;
+    int             backup_interval;    /* 0 indicates no backup */
+    time_t          backup_time;        /* time of the last backup */
+    ViewCursor      cursor;             /* page of the last 'view' */
 };
 
 
@@ -55,6 +64,13 @@ static int edit_wrapper(AppDataPtr appData);
 static int delete_wrapper(AppDataPtr appData);
 static int view_wrapper(AppDataPtr appData);
 static int filter_wrapper(AppDataPtr appData);
+static int summary_wrapper(AppDataPtr appData);
+static int search_wrapper(AppDataPtr appData);
+static int group_wrapper(AppDataPtr appData);
+static int top_wrapper(AppDataPtr appData);
+static int query_wrapper(AppDataPtr appData);
+static int export_wrapper(AppDataPtr appData);
+static int import_wrapper(AppDataPtr appData);
 static int info_wrapper(AppDataPtr appData);
 
 static int save_wrapper(AppDataPtr appData);
@@ -85,6 +101,13 @@ static const CommandLookup cmd_lookup[] = {
     {"delete"   , delete_wrapper    },
     {"view"     , view_wrapper      },
     {"filter"   , filter_wrapper    },
+    {"summary"  , summary_wrapper   },
+    {"search"   , search_wrapper    },
+    {"group"    , group_wrapper     },
+    {"top"      , top_wrapper       },
+    {"query"    , query_wrapper     },
+    {"export"   , export_wrapper    },
+    {"import"   , import_wrapper    },
     {"info"     , info_wrapper      },
     {"save"     , save_wrapper      },
     {"close"    , close_wrapper     },
@@ -117,8 +140,11 @@ AppDataPtr createAppData(void)
         return NULL;
     }
 
-    appData->inex       = NULL;
-    appData->saved      = 0;
+    appData->inex               = NULL;
+    appData->saved              = 0;
+    appData->backup_interval    = BACKUP_INTERVAL;
+    appData->backup_time        = time(NULL);
+    appData->cursor.valid       = 0;
 
     return appData;
 }
@@ -183,11 +209,67 @@ void destroyAppData(AppDataPtr appData)
         free(appData->token);
         appData->token = NULL;
     }
+
+    destroyWorkerPool();
         
     free(appData);
 }
 
 
+/*
+ * Function to start the temporary backup of the opened file (in background),
+ * when the backup interval is elapsed after the last backup
+ * prompt is never blocked, backup file is written by another thread
+ */
+void createTemporaryBackup(AppDataPtr appData)
+{
+    time_t now;
+
+    if (appData == NULL || appData->inex == NULL || appData->saved)
+        return;
+
+    if (appData->backup_interval <= 0)
+        return;
+
+    now = time(NULL);
+
+    if (difftime(now, appData->backup_time) < appData->backup_interval)
+        return;
+
+    /* if backup is not started now, try again after the next command */
+    if (backupInexData(appData->inex) == 0)
+        appData->backup_time = now;
+}
+
+
+/*
+ * To set the interval (in seconds) of the temporary backup
+ * 0 indicates no backup
+ */
+void setBackupInterval(AppDataPtr appData, int seconds)
+{
+    if (appData == NULL || seconds < 0)
+        return;
+
+    appData->backup_interval = seconds;
+}
+
+
+/*
+ * To set the no of threads used to scan the records (1 for no workers)
+ *
+ * Return = 0, indicates success
+ * Return > 0, indicates invalid no of threads
+ */
+int setScanThreads(AppDataPtr appData, int threads)
+{
+    if (appData == NULL)
+        return 1;
+
+    return setPoolThreads(threads);
+}
+
+
 /*
  * A Generic warpper function to handle the invalid command operation 
  */
@@ -241,7 +323,9 @@ static int create_wrapper(AppDataPtr appData)
     appData->inex   = createInexData(appData->token[1]);
 
     if (appData->inex != NULL) {
-        appData->saved  = 0;
+        appData->saved          = 0;
+        appData->backup_time    = time(NULL);
+        appData->cursor.valid   = 0;
         return 0;
     }
     
@@ -265,7 +349,9 @@ static int open_wrapper(AppDataPtr appData)
         return 1;
     }
 
-    appData->saved  = 1;
+    appData->saved          = 1;
+    appData->backup_time    = time(NULL);
+    appData->cursor.valid   = 0;
 
     return 0;
 }
@@ -424,10 +510,31 @@ static int view_wrapper(AppDataPtr appData)
         return 2;
     }
 
-    if (validTokenCount(appData, 1, 2) == 0)
+    if (validTokenCount(appData, 1, 3) == 0)
         return 3;
 
-    returnCode = viewRecord(appData->inex, appData->token[1]);
+    /* without <count>, pages are shown using the cursor */
+    if (appData->token[1] == NULL
+            || strcmp(appData->token[1], "next") == 0
+            || strcmp(appData->token[1], "prev") == 0
+            || strcmp(appData->token[1], "from") == 0) {
+        if ((appData->token[1] == NULL || strcmp(appData->token[1], "from") != 0)
+                && appData->token[2] != NULL) {
+            puts("\tMESSAGE: Enter valid arguments!");
+            return 4;
+        }
+
+        returnCode = pageRecord(appData->inex, &appData->cursor,
+            appData->token[1], appData->token[2]);
+    } else {
+        if (appData->token[2] != NULL) {
+            puts("\tMESSAGE: Enter valid arguments!");
+            return 4;
+        }
+
+        returnCode = viewRecord(appData->inex, appData->token[1]);
+    }
+
     if (returnCode != 0)
         return 1;
 
@@ -444,7 +551,7 @@ static int filter_wrapper(AppDataPtr appData)
         return 2;
     }
 
-    if (validTokenCount(appData, 4, 5) == 0)
+    if (validTokenCount(appData, 2, MAX_TOKEN - 1) == 0)
         return 3;
 
     returnCode = filterRecord(appData->inex, appData->token);
@@ -457,6 +564,166 @@ static int filter_wrapper(AppDataPtr appData)
 }
 
 
+static int summary_wrapper(AppDataPtr appData) 
+{
+    int returnCode;
+
+    if (appData->inex == NULL) {
+        puts("\tMESSAGE: No File opened!");
+        return 2;
+    }
+
+    if (validTokenCount(appData, 1, 2) == 0)
+        return 3;
+
+    returnCode = summaryRecord(appData->inex, appData->token[1]);
+    if (returnCode != 0) {
+        puts("\tMESSAGE: Enter valid arguments!");
+        return 1;
+    }
+
+    return 0;
+}
+
+
+static int search_wrapper(AppDataPtr appData) 
+{
+    int returnCode;
+
+    if (appData->inex == NULL) {
+        puts("\tMESSAGE: No File opened!");
+        return 2;
+    }
+
+    if (validTokenCount(appData, 2, 3) == 0)
+        return 3;
+
+    /* 'search <text>' or 'search <entity/comment> <text>' */
+    if (appData->token[2] == NULL) {
+        returnCode = searchRecord(appData->inex, NULL, appData->token[1]);
+    } else {
+        returnCode = searchRecord(appData->inex, appData->token[1], 
+            appData->token[2]);
+    }
+
+    if (returnCode != 0) {
+        puts("\tMESSAGE: Enter valid arguments!");
+        return 1;
+    }
+
+    return 0;
+}
+
+
+static int group_wrapper(AppDataPtr appData) 
+{
+    int returnCode;
+
+    if (appData->inex == NULL) {
+        puts("\tMESSAGE: No File opened!");
+        return 2;
+    }
+
+    if (validTokenCount(appData, 3, MAX_TOKEN - 1) == 0)
+        return 3;
+
+    returnCode = groupRecord(appData->inex, appData->token);
+    if (returnCode != 0) {
+        puts("\tMESSAGE: Enter valid arguments!");
+        return 1;
+    }
+
+    return 0;
+}
+
+
+static int top_wrapper(AppDataPtr appData) 
+{
+    int returnCode;
+
+    if (appData->inex == NULL) {
+        puts("\tMESSAGE: No File opened!");
+        return 2;
+    }
+
+    if (validTokenCount(appData, 2, 5) == 0)
+        return 3;
+
+    returnCode = topRecord(appData->inex, appData->token);
+    if (returnCode != 0) {
+        puts("\tMESSAGE: Enter valid arguments!");
+        return 1;
+    }
+
+    return 0;
+}
+
+
+static int query_wrapper(AppDataPtr appData) 
+{
+    int returnCode;
+
+    if (validTokenCount(appData, 3, MAX_TOKEN - 1) == 0)
+        return 3;
+
+    returnCode = queryInexFile(appData->token[1], &appData->token[2]);
+    if (returnCode == 1)
+        puts("\tMESSAGE: Enter valid arguments!");
+
+    if (returnCode != 0)
+        return 1;
+
+    return 0;
+}
+
+
+static int export_wrapper(AppDataPtr appData) 
+{
+    int returnCode;
+
+    if (appData->inex == NULL) {
+        puts("\tMESSAGE: No File opened!");
+        return 2;
+    }
+
+    if (validTokenCount(appData, 3, MAX_TOKEN - 1) == 0)
+        return 3;
+
+    returnCode = exportRecord(appData->inex, appData->token);
+    if (returnCode == 1)
+        puts("\tMESSAGE: Enter valid arguments!");
+
+    if (returnCode != 0)
+        return 1;
+
+    return 0;
+}
+
+
+static int import_wrapper(AppDataPtr appData) 
+{
+    int returnCode;
+
+    if (appData->inex == NULL) {
+        puts("\tMESSAGE: No File opened!");
+        return 2;
+    }
+
+    if (validTokenCount(appData, 2, 2) == 0)
+        return 3;
+
+    returnCode = importRecord(appData->inex, appData->token[1]);
+    if (returnCode != 0) {
+        puts("\tMESSAGE: No record is added!");
+        return 1;
+    }
+
+    appData->saved = 0;
+
+    return 0;
+}
+
+
 static int info_wrapper(AppDataPtr appData) 
 {
     int returnCode;
@@ -479,6 +746,23 @@ static int info_wrapper(AppDataPtr appData)
         puts("*not saved");
     }
 
+    /* 'info verify', to check the totals against all the records */
+    if (appData->token[1] != NULL && strcmp(appData->token[1], "verify") == 0) {
+        printf("\tverified      : ");
+
+        returnCode = verifyInexData(appData->inex);
+        if (returnCode < 0)
+            return 1;
+
+        if (returnCode == 0) {
+            puts("yes");
+        } else {
+            puts("*totals are not matching the records");
+        }
+
+        printf("\tscan kernel   : %s\n", scanKernelName());
+    }
+
     puts("");
 
     return 0;
@@ -655,6 +939,9 @@ static int printCommandPrompt(AppDataPtr appData)
         return -1;
     }
 
+    /* records left in render buffer (if command ended in between) */
+    flushRecordsInConsole();
+
     if (appData->inex != NULL) {
         printf("%s", cmd_line);
 
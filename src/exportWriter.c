@@ -0,0 +1,319 @@
+/*
+ * exportWriter.c
+ *
+ * Export of the records as csv or ndjson (one json object per line),
+ * records are formatted into a large buffer, which is written into
+ * the file only when it is full
+ *
+ *  Created on: 16-Oct-2026
+ *      Author: deepaks
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "headers/exportWriter.h"
+#include "headers/recordFunction.h"
+#include "headers/customError.h"
+
+/* to append the string literal text at str + length */
+#define APPEND_TEXT(str, length, text) \
+    do { \
+        memcpy((str) + (length), text, sizeof(text) - 1); \
+        (length) += sizeof(text) - 1; \
+    } while (0)
+
+
+static int flushExportWriter(ExportWriter *writer);
+static int writeCsvRecord(char *str, const Record *rec);
+static int writeJsonRecord(char *str, const Record *rec);
+static int escapeCsv(char *str, const char *text);
+static int escapeJson(char *str, const char *text);
+
+
+static const char *csv_header = "id,type,amount,date,entity,comment\n";
+static const char *hex_digits = "0123456789abcdef";
+
+
+/*
+ * Function to get the export format from its name (csv or ndjson)
+ *
+ * Return > 0, export format
+ * Return = 0, indicates invalid format name
+ */
+int exportFormat(const char *name)
+{
+    if (name == NULL)
+        return 0;
+
+    if (strcmp(name, "csv") == 0)
+        return EXPORT_CSV;
+
+    if (strcmp(name, "ndjson") == 0)
+        return EXPORT_NDJSON;
+
+    return 0;
+}
+
+
+/*
+ * Function to create the export file (existing file is not overwritten)
+ *
+ * Return = 0, indicates success
+ * Return > 0, indicates file already exists
+ * Return < 0, indicates error
+ */
+int openExportWriter(ExportWriter *writer, const char *path, int format)
+{
+    if (writer == NULL || path == NULL
+            || (format != EXPORT_CSV && format != EXPORT_NDJSON)) {
+        logError(ERROR_FUNC_ARG);
+        return -2;
+    }
+
+    memset(writer, 0, sizeof(*writer));
+    writer->format = format;
+
+    writer->buffer = malloc(EXPORT_BUFFER_SIZE);
+    if (writer->buffer == NULL) {
+        logError(ERROR_MEMORY_ALLOC);
+        return -1;
+    }
+
+    writer->fd = open(path, O_WRONLY | O_CREAT | O_EXCL, 0644);
+    if (writer->fd < 0) {
+        free(writer->buffer);
+        writer->buffer = NULL;
+
+        if (errno == EEXIST)
+            return 1;
+
+        logError(ERROR_FILE_OPEN);
+        return -1;
+    }
+
+    if (format == EXPORT_CSV) {
+        writer->length = strlen(csv_header);
+        memcpy(writer->buffer, csv_header, writer->length);
+    }
+
+    return 0;
+}
+
+
+/*
+ * Function to add the record into export
+ *
+ * Return = 0, indicates success
+ * Return < 0, indicates error
+ */
+int writeExportRecord(ExportWriter *writer, const Record *rec)
+{
+    char *str;
+
+    if (writer == NULL || writer->buffer == NULL || rec == NULL) {
+        logError(ERROR_FUNC_ARG);
+        return -2;
+    }
+
+    if (writer->length + EXPORT_RECORD_MAX > EXPORT_BUFFER_SIZE
+            && flushExportWriter(writer) != 0)
+        return -1;
+
+    str = writer->buffer + writer->length;
+
+    if (writer->format == EXPORT_CSV) {
+        writer->length += writeCsvRecord(str, rec);
+    } else {
+        writer->length += writeJsonRecord(str, rec);
+    }
+
+    writer->count++;
+
+    return 0;
+}
+
+
+/*
+ * Function to write the rest of the buffer, and close the export file
+ *
+ * Return = 0, indicates success
+ * Return < 0, indicates error (export is incomplete)
+ */
+int closeExportWriter(ExportWriter *writer)
+{
+    int returnCode;
+
+    if (writer == NULL || writer->buffer == NULL) {
+        logError(ERROR_FUNC_ARG);
+        return -2;
+    }
+
+    returnCode = flushExportWriter(writer);
+
+    if (close(writer->fd) != 0 && returnCode == 0) {
+        logError(ERROR_FILE_WRITE);
+        returnCode = -1;
+    }
+
+    free(writer->buffer);
+    writer->buffer  = NULL;
+    writer->fd      = -1;
+
+    return returnCode;
+}
+
+
+/*
+ * To write the buffer into the export file
+ */
+static int flushExportWriter(ExportWriter *writer)
+{
+    ssize_t written;
+    int offset = 0;
+
+    while (offset < writer->length) {
+        written = write(writer->fd, writer->buffer + offset,
+            writer->length - offset);
+
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+
+            logError(ERROR_FILE_WRITE);
+            return -1;
+        }
+
+        offset += (int) written;
+    }
+
+    writer->length = 0;
+
+    return 0;
+}
+
+
+/*
+ * To format the record as a csv line: id,type,amount,date,entity,comment
+ */
+static int writeCsvRecord(char *str, const Record *rec)
+{
+    int length;
+
+    length = formatInteger(str, rec->r_id);
+    str[length++] = ',';
+
+    if (rec->r_info & 1) {
+        APPEND_TEXT(str, length, "income,");
+    } else {
+        APPEND_TEXT(str, length, "expense,");
+    }
+
+    length += formatAmount(str + length, rec->r_amount);
+    str[length++] = ',';
+    length += formatDate(str + length, &rec->r_date);
+    str[length++] = ',';
+    length += escapeCsv(str + length, rec->r_entity);
+    str[length++] = ',';
+    length += escapeCsv(str + length, rec->r_comment);
+    str[length++] = '\n';
+
+    return length;
+}
+
+
+/*
+ * To format the record as a json object in a line
+ */
+static int writeJsonRecord(char *str, const Record *rec)
+{
+    int length;
+
+    length = 0;
+    APPEND_TEXT(str, length, "{\"id\":");
+    length += formatInteger(str + length, rec->r_id);
+
+    if (rec->r_info & 1) {
+        APPEND_TEXT(str, length, ",\"type\":\"income\",\"amount\":");
+    } else {
+        APPEND_TEXT(str, length, ",\"type\":\"expense\",\"amount\":");
+    }
+
+    length += formatAmount(str + length, rec->r_amount);
+    APPEND_TEXT(str, length, ",\"date\":\"");
+    length += formatDate(str + length, &rec->r_date);
+    APPEND_TEXT(str, length, "\",\"entity\":\"");
+    length += escapeJson(str + length, rec->r_entity);
+    APPEND_TEXT(str, length, "\",\"comment\":\"");
+    length += escapeJson(str + length, rec->r_comment);
+    APPEND_TEXT(str, length, "\"}\n");
+
+    return length;
+}
+
+
+/*
+ * To write the text as a csv field, text having comma, quote or
+ * line break is quoted (and the quotes in it are doubled)
+ */
+static int escapeCsv(char *str, const char *text)
+{
+    int index, length = 0;
+
+    if (strpbrk(text, ",\"\r\n") == NULL) {
+        length = strlen(text);
+        memcpy(str, text, length);
+        return length;
+    }
+
+    str[length++] = '"';
+
+    for (index = 0; text[index] != '\0'; index++) {
+        if (text[index] == '"')
+            str[length++] = '"';
+
+        str[length++] = text[index];
+    }
+
+    str[length++] = '"';
+
+    return length;
+}
+
+
+/*
+ * To write the text as the content of a json string
+ */
+static int escapeJson(char *str, const char *text)
+{
+    unsigned char ch;
+    int index, length = 0;
+
+    for (index = 0; text[index] != '\0'; index++) {
+        ch = (unsigned char) text[index];
+
+        if (ch == '"' || ch == '\\') {
+            str[length++] = '\\';
+            str[length++] = (char) ch;
+        } else if (ch == '\n') {
+            str[length++] = '\\';
+            str[length++] = 'n';
+        } else if (ch == '\t') {
+            str[length++] = '\\';
+            str[length++] = 't';
+        } else if (ch < 0x20) {
+            memcpy(str + length, "\\u00", 4);
+            str[length + 4] = hex_digits[ch >> 4];
+            str[length + 5] = hex_digits[ch & 15];
+            length += 6;
+        } else {
+            str[length++] = (char) ch;
+        }
+    }
+
+    return length;
+}
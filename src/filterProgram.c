@@ -0,0 +1,410 @@
+/*
+ * filterProgram.c
+ *
+ * Filter expression (AND/OR over the fields of record) compiled into
+ * a small postfix program, which is evaluated for every leaf of records
+ *
+ *  Created on: 16-Oct-2026
+ *      Author: deepaks
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+
+#include "headers/filterProgram.h"
+#include "headers/customError.h"
+#include "headers/recordFunction.h"
+#include "headers/scanKernel.h"
+
+/* state of the compiler, tokens are consumed from the position */
+struct filterCompiler {
+    FilterProgram   *program;
+    char            **token;
+    int             pos;
+};
+
+
+static int compileOr(struct filterCompiler *compiler, DateKey *min, DateKey *max);
+static int compileAnd(struct filterCompiler *compiler, DateKey *min, DateKey *max);
+static int compileTerm(struct filterCompiler *compiler, DateKey *min, DateKey *max);
+static int compileRange(struct filterCompiler *compiler, FilterOp *op);
+static int compileText(struct filterCompiler *compiler, FilterOp *op);
+static FilterOp *addFilterOp(struct filterCompiler *compiler, int op);
+static const char *nextToken(const struct filterCompiler *compiler);
+
+
+/*
+ * Function to compile the filter expression (tokens till NULL)
+ *
+ * expression   : term { [and] term } { or term { [and] term } }
+ * term         : date <min> <max> | amount <min> <max> | in | ex
+ *                | entity <text> | comment <text> | ( expression )
+ * dot(.) is used to ignore either <min> or <max>,
+ * terms without 'and' / 'or' between them are joined by 'and'
+ *
+ * Return = 0, indicates success
+ * Return > 0, indicates invalid expression
+ * Return < 0, indicates error
+ */
+int compileFilter(FilterProgram *program, char **token)
+{
+    struct filterCompiler compiler;
+    int returnCode;
+
+    if (program == NULL || token == NULL) {
+        logError(ERROR_FUNC_ARG);
+        return -2;
+    }
+
+    memset(program, 0, sizeof(*program));
+
+    compiler.program    = program;
+    compiler.token      = token;
+    compiler.pos        = 0;
+
+    returnCode = compileOr(&compiler, &program->min_key, &program->max_key);
+    if (returnCode != 0)
+        return returnCode;
+
+    /* all the tokens should be part of the expression */
+    if (nextToken(&compiler) != NULL)
+        return 1;
+
+    return 0;
+}
+
+
+/*
+ * Function to make a program of a single date or amount range [min, max]
+ */
+void rangeFilter(FilterProgram *program, int op, long min, long max)
+{
+    if (program == NULL)
+        return;
+
+    memset(program, 0, sizeof(*program));
+
+    program->op[0].op   = op;
+    program->op[0].min  = min;
+    program->op[0].max  = max;
+    program->count      = 1;
+
+    program->min_key    = (op == FILTER_DATE) ? (DateKey) min : 0;
+    program->max_key    = (op == FILTER_DATE) ? (DateKey) max : INT_MAX;
+}
+
+
+/*
+ * Function to evaluate the program for all the records of the leaf
+ * every instruction works on a bitmask of the rows (bit i for index i),
+ * ranges are selected by the scan kernels, only the needed columns are read
+ *
+ * mask should have MASK_WORDS(LEAF_CAPACITY) words
+ */
+void selectFilter(const FilterProgram *program, const StoreLeaf *leaf,
+        uint64_t *mask)
+{
+    uint64_t stack[FILTER_MAX_OP][MASK_WORDS(LEAF_CAPACITY)];
+    const FilterOp *op;
+    int words = MASK_WORDS(leaf->count);
+    int top = 0;
+    int i, word, index;
+
+    memset(mask, 0, MASK_WORDS(LEAF_CAPACITY) * sizeof(*mask));
+
+    if (leaf->count == 0)
+        return;
+
+    for (i = 0; i < program->count; i++) {
+        op = &program->op[i];
+
+        switch (op->op) {
+            case FILTER_DATE:
+                selectIntRange(leaf->date_key, leaf->count, (int) op->min,
+                    (int) op->max, stack[top++]);
+                break;
+
+            case FILTER_AMOUNT:
+                selectLongRange(leaf->amount, leaf->count, op->min, op->max,
+                    stack[top++]);
+                break;
+
+            case FILTER_TYPE:
+                selectInfoType(leaf->info, leaf->count, (int) op->min,
+                    stack[top++]);
+                break;
+
+            case FILTER_ENTITY:
+            case FILTER_COMMENT:
+                memset(stack[top], 0, words * sizeof(stack[top][0]));
+
+                for (index = 0; index < leaf->count; index++) {
+                    if (strstr((op->op == FILTER_ENTITY) ? leaf->entity[index]
+                            : leaf->comment[index], op->text) != NULL)
+                        stack[top][index / MASK_BITS] |=
+                            (uint64_t) 1 << (index % MASK_BITS);
+                }
+
+                top++;
+                break;
+
+            case FILTER_AND:
+                top--;
+                for (word = 0; word < words; word++)
+                    stack[top - 1][word] &= stack[top][word];
+                break;
+
+            case FILTER_OR:
+                top--;
+                for (word = 0; word < words; word++)
+                    stack[top - 1][word] |= stack[top][word];
+                break;
+        }
+    }
+
+    if (top > 0)
+        memcpy(mask, stack[0], words * sizeof(*mask));
+}
+
+
+/*
+ * Function to compile the terms joined by 'or'
+ * date range of 'or' covers the date range of every term
+ */
+static int compileOr(struct filterCompiler *compiler, DateKey *min, DateKey *max)
+{
+    DateKey term_min, term_max;
+    const char *token;
+    int returnCode;
+
+    returnCode = compileAnd(compiler, min, max);
+    if (returnCode != 0)
+        return returnCode;
+
+    while ((token = nextToken(compiler)) != NULL && strcmp(token, "or") == 0) {
+        compiler->pos++;
+
+        returnCode = compileAnd(compiler, &term_min, &term_max);
+        if (returnCode != 0)
+            return returnCode;
+
+        if (addFilterOp(compiler, FILTER_OR) == NULL)
+            return 2;
+
+        if (term_min < *min)
+            *min = term_min;
+
+        if (term_max > *max)
+            *max = term_max;
+    }
+
+    return 0;
+}
+
+
+/*
+ * Function to compile the terms joined by 'and' (or nothing)
+ * date range of 'and' is the common date range of all the terms
+ */
+static int compileAnd(struct filterCompiler *compiler, DateKey *min, DateKey *max)
+{
+    DateKey term_min, term_max;
+    const char *token;
+    int returnCode;
+
+    returnCode = compileTerm(compiler, min, max);
+    if (returnCode != 0)
+        return returnCode;
+
+    while ((token = nextToken(compiler)) != NULL
+            && strcmp(token, "or") != 0 && strcmp(token, ")") != 0) {
+        if (strcmp(token, "and") == 0)
+            compiler->pos++;
+
+        returnCode = compileTerm(compiler, &term_min, &term_max);
+        if (returnCode != 0)
+            return returnCode;
+
+        if (addFilterOp(compiler, FILTER_AND) == NULL)
+            return 2;
+
+        if (term_min > *min)
+            *min = term_min;
+
+        if (term_max < *max)
+            *max = term_max;
+    }
+
+    return 0;
+}
+
+
+/*
+ * Function to compile a single term (or an expression within brackets)
+ */
+static int compileTerm(struct filterCompiler *compiler, DateKey *min, DateKey *max)
+{
+    const char *token = nextToken(compiler);
+    FilterOp *op;
+    int returnCode;
+
+    /* terms other than date does not limit the date range */
+    *min = 0;
+    *max = INT_MAX;
+
+    if (token == NULL)
+        return 1;
+
+    compiler->pos++;
+
+    if (strcmp(token, "(") == 0) {
+        returnCode = compileOr(compiler, min, max);
+        if (returnCode != 0)
+            return returnCode;
+
+        token = nextToken(compiler);
+        if (token == NULL || strcmp(token, ")") != 0)
+            return 1;
+
+        compiler->pos++;
+        return 0;
+    }
+
+    if (strcmp(token, "date") == 0) {
+        op = addFilterOp(compiler, FILTER_DATE);
+        if (op == NULL || compileRange(compiler, op) != 0)
+            return 1;
+
+        *min = op->min;
+        *max = op->max;
+        return 0;
+    }
+
+    if (strcmp(token, "amount") == 0) {
+        op = addFilterOp(compiler, FILTER_AMOUNT);
+        return (op == NULL || compileRange(compiler, op) != 0) ? 1 : 0;
+    }
+
+    if (strcmp(token, "in") == 0 || strcmp(token, "ex") == 0) {
+        op = addFilterOp(compiler, FILTER_TYPE);
+        if (op == NULL)
+            return 1;
+
+        op->min = (token[0] == 'i');
+        return 0;
+    }
+
+    if (strcmp(token, "entity") == 0) {
+        op = addFilterOp(compiler, FILTER_ENTITY);
+        return (op == NULL || compileText(compiler, op) != 0) ? 1 : 0;
+    }
+
+    if (strcmp(token, "comment") == 0) {
+        op = addFilterOp(compiler, FILTER_COMMENT);
+        return (op == NULL || compileText(compiler, op) != 0) ? 1 : 0;
+    }
+
+    return 1;
+}
+
+
+/*
+ * Function to parse the <min> <max> values of date or amount term
+ * dot(.) is used to ignore either <min> or <max>
+ */
+static int compileRange(struct filterCompiler *compiler, FilterOp *op)
+{
+    const char *value[2];
+    Date date;
+    long amount;
+    int i;
+
+    value[0] = nextToken(compiler);
+    if (value[0] == NULL)
+        return 1;
+
+    compiler->pos++;
+
+    value[1] = nextToken(compiler);
+    if (value[1] == NULL)
+        return 1;
+
+    compiler->pos++;
+
+    op->min = 0;
+    op->max = (op->op == FILTER_DATE) ? INT_MAX : LONG_MAX;
+
+    for (i = 0; i < 2; i++) {
+        if (strcmp(value[i], ".") == 0)
+            continue;
+
+        if (op->op == FILTER_DATE) {
+            if (parseStringToDate(value[i], &date) != 0)
+                return 1;
+
+            amount = DATE_KEY(date);
+        } else {
+            if (parseStringToAmount(value[i], &amount) != 0)
+                return 1;
+        }
+
+        if (i == 0) {
+            op->min = amount;
+        } else {
+            op->max = amount;
+        }
+    }
+
+    return 0;
+}
+
+
+/*
+ * Function to copy the text of entity or comment term (without quotes)
+ */
+static int compileText(struct filterCompiler *compiler, FilterOp *op)
+{
+    const char *value = nextToken(compiler);
+    size_t length;
+
+    if (value == NULL)
+        return 1;
+
+    compiler->pos++;
+
+    if (value[0] == '\'')
+        value++;
+
+    length = strlen(value);
+
+    if (length > 0 && value[length - 1] == '\'')
+        length--;
+
+    if (length == 0 || length >= sizeof(op->text))
+        return 1;
+
+    memcpy(op->text, value, length);
+    op->text[length] = '\0';
+
+    return 0;
+}
+
+
+static FilterOp *addFilterOp(struct filterCompiler *compiler, int op)
+{
+    FilterProgram *program = compiler->program;
+
+    if (program->count == FILTER_MAX_OP)
+        return NULL;
+
+    program->op[program->count].op = op;
+
+    return &program->op[program->count++];
+}
+
+
+static const char *nextToken(const struct filterCompiler *compiler)
+{
+    return compiler->token[compiler->pos];
+}
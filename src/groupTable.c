@@ -0,0 +1,243 @@
+/*
+ * groupTable.c
+ *
+ * Hash aggregation of the records into groups of entity, month, year or type
+ * (open addressing with linear probing)
+ *
+ *  Created on: 16-Oct-2026
+ *      Author: deepaks
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "headers/groupTable.h"
+#include "headers/customError.h"
+#include "headers/rollup.h"
+
+#define MIN_CAPACITY    64
+
+/* Fibonacci hashing, capacity is always a power of 2 */
+#define HASH_SLOT(hash, capacity) \
+    ((int) (((hash) * 2654435769u) & (unsigned int) ((capacity) - 1)))
+
+
+static unsigned int hashName(const char *name);
+static GroupBucket *getGroup(GroupTable *table, unsigned int hash, int key,
+        const char *name);
+static int resizeGroupTable(GroupTable *table, int capacity);
+static int compareGroup(const void *a, const void *b);
+
+
+/*
+ * To initialize an empty table, to group the records by the field
+ */
+void initGroupTable(GroupTable *table, int by)
+{
+    if (table == NULL)
+        return;
+
+    memset(table, 0, sizeof(*table));
+    table->by = by;
+}
+
+
+/*
+ * To free the groups of the table
+ */
+void freeGroupTable(GroupTable *table)
+{
+    if (table == NULL)
+        return;
+
+    free(table->slot);
+    initGroupTable(table, table->by);
+}
+
+
+/*
+ * Function to add the record into its group (group is added if not present)
+ *
+ * Return = 0, indicates success
+ * Return < 0, indicates error (table is marked as lost)
+ */
+int addGroupRecord(GroupTable *table, const char *entity, DateKey key,
+        int info, long amount)
+{
+    GroupBucket *group;
+    unsigned int hash;
+    int group_key = 0;
+
+    if (table == NULL || entity == NULL) {
+        logError(ERROR_FUNC_ARG);
+        return -2;
+    }
+
+    switch (table->by) {
+        case GROUP_ENTITY:
+            hash = hashName(entity);
+            break;
+
+        case GROUP_MONTH:
+            group_key = MONTH_PERIOD(key);
+            hash = group_key;
+            break;
+
+        case GROUP_YEAR:
+            group_key = KEY_YEAR(key);
+            hash = group_key;
+            break;
+
+        default:
+            group_key = info & 1;
+            hash = group_key;
+            break;
+    }
+
+    group = getGroup(table, hash, group_key,
+        (table->by == GROUP_ENTITY) ? entity : NULL);
+
+    if (group == NULL) {
+        table->lost = 1;
+        return -1;
+    }
+
+    group->count++;
+
+    if (info & 1) {
+        group->income += amount;
+    } else {
+        group->expense += amount;
+    }
+
+    return 0;
+}
+
+
+/*
+ * Function to move the groups to the start of the table, sorted by
+ * entity name or key (no more records can be added after this)
+ */
+void sortGroupTable(GroupTable *table)
+{
+    int pos, count = 0;
+
+    if (table == NULL || table->count == 0)
+        return;
+
+    for (pos = 0; pos < table->capacity; pos++) {
+        if (table->slot[pos].count != 0)
+            table->slot[count++] = table->slot[pos];
+    }
+
+    qsort(table->slot, count, sizeof(*table->slot), compareGroup);
+}
+
+
+/*
+ * FNV-1a hash of the entity name
+ */
+static unsigned int hashName(const char *name)
+{
+    unsigned int hash = 2166136261u;
+
+    while (*name != '\0') {
+        hash ^= (unsigned char) *name++;
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+
+/*
+ * Function to find the group, added (with no records) if not present
+ */
+static GroupBucket *getGroup(GroupTable *table, unsigned int hash, int key,
+        const char *name)
+{
+    GroupBucket *group;
+    int pos;
+
+    /* keep the load factor below 0.5, so that probes are short */
+    if ((table->count + 1) * 2 > table->capacity) {
+        if (resizeGroupTable(table, (table->capacity > 0)
+                ? table->capacity * 2 : MIN_CAPACITY) != 0)
+            return NULL;
+    }
+
+    pos = HASH_SLOT(hash, table->capacity);
+
+    while (table->slot[pos].count != 0) {
+        group = &table->slot[pos];
+
+        if (group->hash == hash && group->key == key
+                && (name == NULL || strcmp(group->name, name) == 0))
+            return group;
+
+        pos = (pos + 1) & (table->capacity - 1);
+    }
+
+    group = &table->slot[pos];
+    group->hash = hash;
+    group->key  = key;
+
+    if (name != NULL) {
+        strncpy(group->name, name, ENTITY_LEN - 1);
+        group->name[ENTITY_LEN - 1] = '\0';
+    }
+
+    table->count++;
+
+    return group;
+}
+
+
+/*
+ * Function to rehash all the groups into a new table of given capacity
+ */
+static int resizeGroupTable(GroupTable *table, int capacity)
+{
+    GroupBucket *old_slot = table->slot;
+    int old_capacity = table->capacity;
+    int pos, table_pos;
+
+    table->slot = calloc(capacity, sizeof(*table->slot));
+    if (table->slot == NULL) {
+        table->slot = old_slot;
+        logError(ERROR_MEMORY_ALLOC);
+        return -1;
+    }
+
+    table->capacity = capacity;
+
+    for (pos = 0; pos < old_capacity; pos++) {
+        if (old_slot[pos].count == 0)
+            continue;
+
+        table_pos = HASH_SLOT(old_slot[pos].hash, capacity);
+
+        while (table->slot[table_pos].count != 0)
+            table_pos = (table_pos + 1) & (capacity - 1);
+
+        table->slot[table_pos] = old_slot[pos];
+    }
+
+    free(old_slot);
+
+    return 0;
+}
+
+
+static int compareGroup(const void *a, const void *b)
+{
+    const GroupBucket *x = a;
+    const GroupBucket *y = b;
+    int returnCode;
+
+    returnCode = strcmp(x->name, y->name);
+    if (returnCode != 0)
+        return returnCode;
+
+    return (x->key > y->key) - (x->key < y->key);
+}
@@ -13,4 +13,8 @@ void destroyAppData(AppDataPtr appData);
 
 void createTemporaryBackup(AppDataPtr appData);
 
+void setBackupInterval(AppDataPtr appData, int seconds);
+
+int setScanThreads(AppDataPtr appData, int threads);
+
 #endif 
\ No newline at end of file
@@ -11,6 +11,17 @@ typedef struct date {
     int year;
 } Date;
 
+/*
+ * Date packed into a single integer (year << 9 | month << 5 | day)
+ * keys of valid dates are in the same order as the dates
+ */
+typedef int DateKey;
+
+#define DATE_KEY(d)     (((d).year << 9) | ((d).month << 5) | (d).day)
+#define KEY_YEAR(k)     ((k) >> 9)
+#define KEY_MONTH(k)    (((k) >> 5) & 15)
+#define KEY_DAY(k)      ((k) & 31)
+
 typedef struct record {
     int         r_id;
     int         r_info;
@@ -0,0 +1,36 @@
+#ifndef EXPORT_WRITER_H
+#define EXPORT_WRITER_H
+
+#include "dataDefinition.h"
+
+/* formats of the export */
+#define EXPORT_CSV          1
+#define EXPORT_NDJSON       2
+
+/* records are formatted into the buffer, and written when it is full */
+#define EXPORT_BUFFER_SIZE  (1024 * 1024)
+
+/* maximum length of a record, after escaping entity and comment */
+#define EXPORT_RECORD_MAX   2048
+
+/*
+ * Writer of the records into an export file (csv or ndjson)
+ */
+typedef struct exportWriter {
+    int             fd;
+    int             format;
+    int             length;     /* length of the text in buffer */
+    int             count;      /* no of records written */
+    char            *buffer;
+} ExportWriter;
+
+
+int exportFormat(const char *name);
+
+int openExportWriter(ExportWriter *writer, const char *path, int format);
+
+int writeExportRecord(ExportWriter *writer, const Record *rec);
+
+int closeExportWriter(ExportWriter *writer);
+
+#endif
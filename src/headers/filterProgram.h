@@ -0,0 +1,52 @@
+#ifndef FILTER_PROGRAM_H
+#define FILTER_PROGRAM_H
+
+#include <stdint.h>
+
+#include "dataDefinition.h"
+#include "recordStore.h"
+
+#define FILTER_MAX_OP   32
+
+/* instructions of the filter program */
+#define FILTER_DATE     1
+#define FILTER_AMOUNT   2
+#define FILTER_TYPE     3
+#define FILTER_ENTITY   4
+#define FILTER_COMMENT  5
+#define FILTER_AND      6
+#define FILTER_OR       7
+
+/*
+ * One instruction of the filter program
+ * date and amount are checked within [min, max],
+ * entity and comment should contain the text
+ */
+typedef struct filterOp {
+    int     op;
+    long    min;
+    long    max;
+    char    text[COMMENT_LEN];
+} FilterOp;
+
+/*
+ * Filter expression compiled into postfix order, evaluated on a stack
+ * of bitmasks (one bit for every record of a leaf)
+ * dates of all the matching records are within [min_key, max_key]
+ */
+typedef struct filterProgram {
+    FilterOp    op[FILTER_MAX_OP];
+    int         count;
+    DateKey     min_key;
+    DateKey     max_key;
+} FilterProgram;
+
+
+int compileFilter(FilterProgram *program, char **token);
+
+void rangeFilter(FilterProgram *program, int op, long min, long max);
+
+void selectFilter(const FilterProgram *program, const StoreLeaf *leaf,
+        uint64_t *mask);
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef GROUP_TABLE_H
+#define GROUP_TABLE_H
+
+#include "dataDefinition.h"
+
+/* field of the record, by which records are grouped */
+#define GROUP_ENTITY    1
+#define GROUP_MONTH     2
+#define GROUP_YEAR      3
+#define GROUP_TYPE      4
+
+/*
+ * Totals of the records of a group
+ * key is the month period, year or type (1 - income, 0 - expense),
+ * name is the entity (only for GROUP_ENTITY)
+ */
+typedef struct groupBucket {
+    unsigned int    hash;
+    int             key;
+    int             count;      /* 0 for empty slot */
+    long            income;
+    long            expense;
+    char            name[ENTITY_LEN];
+} GroupBucket;
+
+/*
+ * Hash table of groups (open addressing)
+ * after sortGroupTable, groups are at the start of slot in order
+ */
+typedef struct groupTable {
+    int             by;
+    int             count;
+    int             capacity;
+    int             lost;       /* a record could not be added */
+    GroupBucket     *slot;
+} GroupTable;
+
+
+void initGroupTable(GroupTable *table, int by);
+
+void freeGroupTable(GroupTable *table);
+
+int addGroupRecord(GroupTable *table, const char *entity, DateKey key,
+        int info, long amount);
+
+void sortGroupTable(GroupTable *table);
+
+#endif
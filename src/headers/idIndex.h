@@ -0,0 +1,30 @@
+#ifndef ID_INDEX_H
+#define ID_INDEX_H
+
+/*
+ * Hash index from record id into a reference (open addressing)
+ * record id should be a positive value
+ */
+typedef struct idSlot {
+    int     id;
+    void    *ref;
+} IdSlot;
+
+typedef struct idIndex {
+    int     count;
+    int     capacity;
+    IdSlot  *slot;
+} IdIndex;
+
+
+void initIdIndex(IdIndex *index);
+
+void freeIdIndex(IdIndex *index);
+
+int putIdIndex(IdIndex *index, int id, void *ref);
+
+void *getIdIndex(const IdIndex *index, int id);
+
+int removeIdIndex(IdIndex *index, int id);
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef IMPORT_READER_H
+#define IMPORT_READER_H
+
+#include <stdio.h>
+
+#include "dataDefinition.h"
+
+/* file is read into the buffer, a large chunk at a time */
+#define IMPORT_BUFFER_SIZE  (1024 * 1024)
+
+/* columns of the csv: id,type,amount,date,entity,comment */
+#define IMPORT_FIELDS       6
+#define IMPORT_FIELD_LEN    COMMENT_LEN
+
+/*
+ * Reader of the records from a csv file (same columns as the export)
+ */
+typedef struct importReader {
+    FILE            *fp;
+    char            *buffer;
+    int             length;     /* length of the text in buffer */
+    int             offset;     /* next character to parse */
+    int             line;       /* line no of the last record read */
+    int             newlines;   /* line breaks read so far */
+    char            field[IMPORT_FIELDS][IMPORT_FIELD_LEN];
+} ImportReader;
+
+
+int openImportReader(ImportReader *reader, const char *path);
+
+int readImportRecord(ImportReader *reader, Record *rec);
+
+void closeImportReader(ImportReader *reader);
+
+#endif
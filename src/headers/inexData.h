@@ -6,6 +6,18 @@
 /* Incomplete DataType */
 typedef struct inexData* InexDataPtr;
 
+/*
+ * Page of records shown by 'view' (newest and oldest record of the page)
+ * records are found again by id, so the cursor stays valid after edits
+ */
+typedef struct viewCursor {
+    int     valid;
+    int     first_id;
+    DateKey first_key;
+    int     last_id;
+    DateKey last_key;
+} ViewCursor;
+
 
 /* InEx Data operations */
 InexDataPtr createInexData(const char *fileName);
@@ -14,8 +26,12 @@ InexDataPtr openInexDataFromFile(const char *fileName);
 
 int infoInexData(InexDataPtr inex);
 
+int verifyInexData(InexDataPtr inex);
+
 int saveInexData(InexDataPtr inex);
 
+int backupInexData(InexDataPtr inex);
+
 void destroyInexData(InexDataPtr inex);
 
 
@@ -24,6 +40,8 @@ int removeInexFile(const char *fileName);
 
 void listInexFile();
 
+int queryInexFile(const char *fileName, char **token);
+
 
 /* InEx Record operations */
 int addRecord(InexDataPtr inex, Record *rec);
@@ -34,8 +52,23 @@ int deleteRecord(InexDataPtr inex, int record_id);
 
 int viewRecord(InexDataPtr inex, const char *argument);
 
+int pageRecord(InexDataPtr inex, ViewCursor *cursor, const char *direction,
+        const char *argument);
+
+int summaryRecord(InexDataPtr inex, const char *argument);
+
+int searchRecord(InexDataPtr inex, const char *field, const char *text);
+
+int groupRecord(InexDataPtr inex, char **token);
+
+int topRecord(InexDataPtr inex, char **token);
+
 int filterRecord(InexDataPtr inex, char **token);
 
+int exportRecord(InexDataPtr inex, char **token);
+
+int importRecord(InexDataPtr inex, const char *path);
+
 
 /* other InEx functions */
 void showFileName(InexDataPtr inex);
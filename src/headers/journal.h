@@ -0,0 +1,51 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include "dataDefinition.h"
+
+/* operations recorded in the journal */
+#define JOURNAL_ADD         1
+#define JOURNAL_EDIT        2   /* record is kept in the same position */
+#define JOURNAL_EDIT_DATE   3   /* record is moved after the same dates */
+#define JOURNAL_DELETE      4
+
+/*
+ * One change of the records, the complete record (after the change)
+ * is kept, so that applying an entry again gives the same result
+ */
+typedef struct journalEntry {
+    int             je_operation;
+    unsigned int    je_checksum;
+    Record          je_record;
+} JournalEntry;
+
+/*
+ * Append only journal of the changes, kept next to the InEx file
+ * changes are buffered in memory, until they are flushed on save
+ */
+typedef struct journal {
+    JournalEntry    *entry;
+    int             count;          /* buffered entries (not yet flushed) */
+    int             capacity;
+    long            file_entries;   /* entries already in the journal file */
+    int             lost;           /* a change could not be buffered */
+} Journal;
+
+/* Function Pointer type definition to apply the journal entries */
+typedef int (*JournalReplay)(void *context, int operation, const Record *rec);
+
+
+void initJournal(Journal *journal);
+
+void freeJournal(Journal *journal);
+
+int appendJournal(Journal *journal, int operation, const Record *rec);
+
+int flushJournal(Journal *journal, const char *journalFileName);
+
+int replayJournal(Journal *journal, const char *journalFileName,
+        JournalReplay replay, void *context);
+
+int removeJournal(Journal *journal, const char *journalFileName);
+
+#endif
@@ -3,6 +3,10 @@
 
 #include "dataDefinition.h"
 
+/* maximum length of the formatted texts (without null character) */
+#define AMOUNT_TEXT_LEN     24
+#define DATE_TEXT_LEN       10
+
 
 /* get Input From Console Functions */
 int getDateFromConsole(Date *date);
@@ -33,20 +37,26 @@ int isValidRecordEntity(const Record *rec);
 
 int isValidRecordComment(const Record *rec);
 
-int isRecordBetweenDateRange(const Record *rec, Date *d1, Date *d2);
-
-int isRecordBetweenAmountRange(const Record *rec, long *a1, long *a2);
-
 
 /* other functions */
-int compareDate(Date d1, Date d2);
+Date keyToDate(DateKey key);
 
 int copyRecord(Record *dest, Record *src);
 
 
+/* data formatting functions */
+int formatAmount(char *str, long amount);
+
+int formatDate(char *str, const Date *date);
+
+int formatInteger(char *str, long value);
+
+
 /* print record in console function */
 int printRecordInConsole(const Record *rec);
 
+void flushRecordsInConsole();
+
 void printRecordHeaderInConsole();
 
 void printRecordFooterInConsole();
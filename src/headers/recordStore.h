@@ -0,0 +1,180 @@
+#ifndef RECORD_STORE_H
+#define RECORD_STORE_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+#include "dataDefinition.h"
+#include "idIndex.h"
+#include "slab.h"
+
+#define LEAF_CAPACITY   256
+
+/* no of records and their sum of amount (income and expense separately) */
+typedef struct storeTotals {
+    int                 count;
+    long                income;
+    long                expense;
+} StoreTotals;
+
+/*
+ * Leaf of the store, a columnar (structure of arrays) block of records
+ * sorted by date (oldest record at index 0)
+ *
+ * entity and comment are kept in separate side columns,
+ * so that scans touch only the columns needed for a query
+ */
+typedef struct storeLeaf {
+    int                 count;
+
+    int                 *id;
+    int                 *info;
+    DateKey             *date_key;
+    long                *amount;
+    char                (*entity)[ENTITY_LEN];
+    char                (*comment)[COMMENT_LEN];
+
+    /* memory of the columns, NULL if columns are pointing into a mapping */
+    void                *block;
+    int                 epoch;      /* store epoch, when the block was created */
+
+    StoreTotals         total;      /* valid, only if totals of store are built */
+
+    struct storeNode    *parent;
+    struct storeLeaf    *prev;
+    struct storeLeaf    *next;
+} StoreLeaf;
+
+/*
+ * Store of records sorted by date, as a B+tree of leaves
+ * leaves are linked from the oldest (head) to the latest (tail)
+ */
+typedef struct recordStore {
+    int                 count;
+    struct storeNode    *root;
+    StoreLeaf           *head;
+    StoreLeaf           *tail;
+
+    /* file mapping, which the leaves of an opened file are pointing into */
+    void                *map_base;
+    size_t              map_length;
+
+    /* record id into leaf, built on the first lookup by id */
+    IdIndex             id_index;
+    int                 indexed;
+
+    /* totals of every leaf and node, built on the first range total */
+    int                 totaled;
+
+    /* 
+     * while a snapshot is active, leaves older than the current epoch 
+     * are copied before modification, old blocks are retired (not freed)
+     */
+    int                 epoch;
+    int                 snapshot_active;
+    void                **retired;
+    int                 retired_count;
+    int                 retired_capacity;
+
+    /* memory of the leaves, their blocks and the nodes */
+    Slab                leaf_slab;
+    Slab                block_slab;
+    Slab                node_slab;
+} RecordStore;
+
+/* 
+ * Snapshot (copy on write) of the store, which can be written into file
+ * while the store is modified (only one snapshot at a time)
+ */
+typedef struct storeSnapshot {
+    int                 count;
+    int                 no_of_leaf;
+    StoreLeaf           *leaf;      /* copy of the leaves (columns are shared) */
+} StoreSnapshot;
+
+/*
+ * Reader of the columns of a store file, from the latest record
+ * columns are read a chunk of records at a time (chunk is not part of
+ * any store, and can have more than LEAF_CAPACITY records)
+ */
+typedef struct storeStream {
+    FILE                *fp;
+    long                start;      /* start of the columns in file */
+    int                 count;      /* no of records in file */
+    int                 remaining;  /* records older than the chunk */
+    StoreLeaf           chunk;
+    void                *block;
+} StoreStream;
+
+/* Position of a record within the store */
+typedef struct storePos {
+    StoreLeaf           *leaf;
+    int                 index;
+} StorePos;
+
+
+/* store operations */
+void initRecordStore(RecordStore *store);
+
+void freeRecordStore(RecordStore *store);
+
+
+/* record operations */
+int insertStoreRecord(RecordStore *store, const Record *rec);
+
+int mergeStoreRecords(RecordStore *store, const Record **batch, int count);
+
+int removeStoreRecord(RecordStore *store, const StorePos *pos);
+
+int findStoreRecord(RecordStore *store, int record_id, StorePos *pos);
+
+int getStoreRecord(const StorePos *pos, Record *rec);
+
+int setStoreRecord(RecordStore *store, const StorePos *pos, const Record *rec);
+
+
+/* position operations */
+int lastStorePos(const RecordStore *store, StorePos *pos);
+
+int seekStoreDate(const RecordStore *store, DateKey key, StorePos *pos);
+
+int prevStorePos(StorePos *pos);
+
+int nextStorePos(StorePos *pos);
+
+
+/* aggregate operations */
+int rangeStoreTotals(RecordStore *store, DateKey min, DateKey max,
+        StoreTotals *totals);
+
+
+/* store file operations */
+size_t recordStoreFileSize(int count);
+
+int attachRecordStore(RecordStore *store, void *map_base, size_t map_length,
+        size_t offset, int count);
+
+int readRecordStore(RecordStore *store, FILE *fp, int count);
+
+int loadRecordStoreV2(RecordStore *store, const void *columns, size_t length,
+        int count);
+
+int writeRecordStore(const RecordStore *store, FILE *fp);
+
+
+/* store file stream operations */
+int openStoreStream(StoreStream *stream, FILE *fp, int count, DateKey max_key);
+
+int readStoreStream(StoreStream *stream);
+
+void closeStoreStream(StoreStream *stream);
+
+
+/* snapshot operations */
+int snapshotRecordStore(RecordStore *store, StoreSnapshot *snapshot);
+
+int writeStoreSnapshot(const StoreSnapshot *snapshot, FILE *fp);
+
+void releaseStoreSnapshot(RecordStore *store, StoreSnapshot *snapshot);
+
+#endif
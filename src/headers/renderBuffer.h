@@ -0,0 +1,15 @@
+#ifndef RENDER_BUFFER_H
+#define RENDER_BUFFER_H
+
+/*
+ * Size of the render buffer, rows are formatted into it
+ * and written to stdout with a single write when it is full (or flushed)
+ */
+#define RENDER_BUFFER_SIZE  (256 * 1024)
+
+
+void renderText(const char *text, int length);
+
+int flushRender();
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+
+#include <stdint.h>
+
+#include "recordStore.h"
+#include "filterProgram.h"
+#include "scanKernel.h"
+
+#define RESULT_CACHE_SIZE   8
+
+/*
+ * Result of a scan, the leaves having matching records and their masks
+ * leaves are valid only till the records are changed (generation)
+ */
+typedef struct cachedResult {
+    FilterProgram       program;
+    long                generation;
+    long                used;       /* 0 for empty entry */
+    StoreTotals         totals;
+    int                 count;
+    const StoreLeaf     **leaf;
+    uint64_t            (*mask)[MASK_WORDS(LEAF_CAPACITY)];
+} CachedResult;
+
+/*
+ * Recent scan results, least recently used one is replaced
+ */
+typedef struct resultCache {
+    CachedResult        entry[RESULT_CACHE_SIZE];
+    long                tick;
+} ResultCache;
+
+
+void initResultCache(ResultCache *cache);
+
+void freeResultCache(ResultCache *cache);
+
+const CachedResult *findResultCache(ResultCache *cache,
+        const FilterProgram *program, long generation);
+
+int addResultCache(ResultCache *cache, const FilterProgram *program,
+        long generation, const StoreTotals *totals, const StoreLeaf **leaf,
+        uint64_t (*mask)[MASK_WORDS(LEAF_CAPACITY)], int count);
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef ROLLUP_H
+#define ROLLUP_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+#include "dataDefinition.h"
+
+/* period of the month bucket (year << 4 | month) for the date key */
+#define MONTH_PERIOD(key)   ((key) >> 5)
+#define PERIOD_YEAR(p)      ((p) >> 4)
+#define PERIOD_MONTH(p)     ((p) & 15)
+
+/*
+ * Totals of the records of a period (a month or a year)
+ */
+typedef struct rollupBucket {
+    int     period;
+    int     count;
+    long    income;
+    long    expense;
+} RollupBucket;
+
+/* buckets sorted by period, only the periods having records are kept */
+typedef struct rollupList {
+    RollupBucket    *bucket;
+    int             count;
+    int             capacity;
+} RollupList;
+
+/*
+ * Per month and per year totals of the records,
+ * maintained on every change of the records
+ */
+typedef struct rollup {
+    RollupList      month;
+    RollupList      year;
+    int             lost;       /* a change could not be applied */
+} Rollup;
+
+
+void initRollup(Rollup *rollup);
+
+void freeRollup(Rollup *rollup);
+
+int applyRollup(Rollup *rollup, DateKey key, int info, long amount, int sign);
+
+int findRollup(const RollupList *list, int period);
+
+int copyRollup(Rollup *dest, const Rollup *src);
+
+
+/* rollup file operations */
+int writeRollup(const Rollup *rollup, FILE *fp);
+
+int loadRollup(Rollup *rollup, const void *data, size_t length);
+
+int readRollup(Rollup *rollup, FILE *fp);
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef SCAN_KERNEL_H
+#define SCAN_KERNEL_H
+
+#include <stdint.h>
+
+/* no of rows in a word of the selection mask */
+#define MASK_BITS           64
+#define MASK_WORDS(count)   (((count) + MASK_BITS - 1) / MASK_BITS)
+
+/*
+ * Kernels over the columns of records (contiguous arrays)
+ * selection of the rows is given as a bitmask (bit i of the mask for row i)
+ * vectorized (AVX2 or SSE4.2) where the cpu supports it, else scalar
+ */
+
+void selectLongRange(const long *column, int count, long min, long max,
+        uint64_t *mask);
+
+void selectIntRange(const int *column, int count, int min, int max,
+        uint64_t *mask);
+
+void selectInfoType(const int *info, int count, int type, uint64_t *mask);
+
+int sumSelected(const long *amount, const int *info, int count,
+        const uint64_t *mask, long *income, long *expense);
+
+const char *scanKernelName(void);
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef SLAB_H
+#define SLAB_H
+
+#include <stddef.h>
+
+/*
+ * Allocator of fixed size objects, carved from large chunks
+ * freed objects are kept in a free list for reuse, and
+ * all the chunks are freed together when the slab is destroyed
+ */
+typedef struct slab {
+    size_t  size;           /* size of an object */
+    int     per_chunk;      /* no of objects in a chunk */
+    void    *chunk;         /* list of chunks */
+    char    *next;          /* next unused object of the latest chunk */
+    char    *end;
+    void    *free_list;     /* list of freed objects */
+} Slab;
+
+
+void initSlab(Slab *slab, size_t size, int per_chunk);
+
+void destroySlab(Slab *slab);
+
+void *allocSlab(Slab *slab);
+
+void freeSlab(Slab *slab, void *object);
+
+#endif
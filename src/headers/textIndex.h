@@ -0,0 +1,46 @@
+#ifndef TEXT_INDEX_H
+#define TEXT_INDEX_H
+
+/* fields of the record, which are indexed */
+#define TEXT_ENTITY     1
+#define TEXT_COMMENT    2
+
+/* no of characters in a gram, shorter text cannot be searched in index */
+#define TEXT_GRAM_LEN   3
+
+/*
+ * Sorted ids of the records having the trigram in the field
+ * key is field << 24 | the 3 characters (0 for empty slot)
+ */
+typedef struct textPosting {
+    unsigned int    key;
+    int             count;
+    int             capacity;
+    int             *id;
+} TextPosting;
+
+/*
+ * Inverted index from the trigrams of entity and comment into record ids
+ * (hash table of postings, open addressing)
+ */
+typedef struct textIndex {
+    int             count;
+    int             capacity;
+    TextPosting     *slot;
+} TextIndex;
+
+
+void initTextIndex(TextIndex *index);
+
+void freeTextIndex(TextIndex *index);
+
+int addTextIndex(TextIndex *index, int id, const char *entity,
+        const char *comment);
+
+int removeTextIndex(TextIndex *index, int id, const char *entity,
+        const char *comment);
+
+int searchTextIndex(const TextIndex *index, const char *text, int fields,
+        int **ids, int *count);
+
+#endif
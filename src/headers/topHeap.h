@@ -0,0 +1,34 @@
+#ifndef TOP_HEAP_H
+#define TOP_HEAP_H
+
+/*
+ * A record in the heap, ordered by amount (and id for same amount)
+ * leaf and index refer to the record in store
+ */
+typedef struct topEntry {
+    long            amount;
+    int             id;
+    int             index;
+    const void      *leaf;
+} TopEntry;
+
+/*
+ * Bounded min heap of the k largest records seen so far
+ * smallest of them is at the root, so a new record is compared only with it
+ */
+typedef struct topHeap {
+    int             k;
+    int             count;
+    TopEntry        *entry;
+} TopHeap;
+
+
+int initTopHeap(TopHeap *heap, int k);
+
+void freeTopHeap(TopHeap *heap);
+
+void pushTopHeap(TopHeap *heap, const TopEntry *entry);
+
+void sortTopHeap(TopHeap *heap);
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+/* upper limit for the no of scan threads */
+#define MAX_POOL_THREADS    64
+
+/* function run by the pool for every task (0 till count - 1) */
+typedef void (*PoolTask)(void *context, int task);
+
+
+int setPoolThreads(int threads);
+
+int getPoolThreads(void);
+
+int runWorkerPool(PoolTask task, void *context, int count);
+
+void destroyWorkerPool(void);
+
+#endif
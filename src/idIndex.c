@@ -0,0 +1,198 @@
+/*
+ * idIndex.c
+ *
+ * Hash index for the record id (open addressing with linear probing)
+ *
+ *  Created on: 16-Oct-2026
+ *      Author: deepaks
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "headers/idIndex.h"
+#include "headers/customError.h"
+
+#define MIN_CAPACITY    64
+#define EMPTY_ID        0
+
+/* Fibonacci hashing, capacity is always a power of 2 */
+#define HASH_ID(id, capacity) \
+    ((int) (((unsigned int) (id) * 2654435769u) & (unsigned int) ((capacity) - 1)))
+
+
+static int resizeIdIndex(IdIndex *index, int capacity);
+
+
+/*
+ * To initialize an empty index
+ */
+void initIdIndex(IdIndex *index)
+{
+    if (index == NULL)
+        return;
+
+    memset(index, 0, sizeof(*index));
+}
+
+
+/*
+ * To free the index
+ */
+void freeIdIndex(IdIndex *index)
+{
+    if (index == NULL)
+        return;
+
+    free(index->slot);
+    initIdIndex(index);
+}
+
+
+/*
+ * Function to add the id into index, or update its reference if already present
+ *
+ * Return = 0, indicates success
+ * Return < 0, indicates error
+ */
+int putIdIndex(IdIndex *index, int id, void *ref)
+{
+    int pos;
+
+    if (index == NULL || id <= EMPTY_ID) {
+        logError(ERROR_FUNC_ARG);
+        return -2;
+    }
+
+    /* keep the load factor below 0.5, so that probes are short */
+    if ((index->count + 1) * 2 > index->capacity) {
+        if (resizeIdIndex(index, (index->capacity > 0)
+                ? index->capacity * 2 : MIN_CAPACITY) != 0)
+            return -1;
+    }
+
+    pos = HASH_ID(id, index->capacity);
+
+    while (index->slot[pos].id != EMPTY_ID) {
+        if (index->slot[pos].id == id) {
+            index->slot[pos].ref = ref;
+            return 0;
+        }
+
+        pos = (pos + 1) & (index->capacity - 1);
+    }
+
+    index->slot[pos].id     = id;
+    index->slot[pos].ref    = ref;
+    index->count++;
+
+    return 0;
+}
+
+
+/*
+ * Function to get the reference of the id
+ *
+ * Returns NULL, if id is not present
+ */
+void *getIdIndex(const IdIndex *index, int id)
+{
+    int pos;
+
+    if (index == NULL || index->capacity == 0 || id <= EMPTY_ID)
+        return NULL;
+
+    pos = HASH_ID(id, index->capacity);
+
+    while (index->slot[pos].id != EMPTY_ID) {
+        if (index->slot[pos].id == id)
+            return index->slot[pos].ref;
+
+        pos = (pos + 1) & (index->capacity - 1);
+    }
+
+    return NULL;
+}
+
+
+/*
+ * Function to remove the id from the index
+ * following entries of the same probe sequence are shifted back,
+ * so that no deleted marker is needed
+ *
+ * Return = 0, indicates success
+ * Return > 0, indicates id is not present
+ */
+int removeIdIndex(IdIndex *index, int id)
+{
+    int pos, next, home;
+    int mask;
+
+    if (index == NULL || index->capacity == 0 || id <= EMPTY_ID)
+        return 1;
+
+    mask    = index->capacity - 1;
+    pos     = HASH_ID(id, index->capacity);
+
+    while (index->slot[pos].id != id) {
+        if (index->slot[pos].id == EMPTY_ID)
+            return 1;
+
+        pos = (pos + 1) & mask;
+    }
+
+    next = (pos + 1) & mask;
+
+    while (index->slot[next].id != EMPTY_ID) {
+        home = HASH_ID(index->slot[next].id, index->capacity);
+
+        /* move the entry back, if its home is not in between (pos, next] */
+        if (((next - home) & mask) >= ((next - pos) & mask)) {
+            index->slot[pos] = index->slot[next];
+            pos = next;
+        }
+
+        next = (next + 1) & mask;
+    }
+
+    index->slot[pos].id = EMPTY_ID;
+    index->count--;
+
+    return 0;
+}
+
+
+/*
+ * Function to rehash all the entries into a new table of given capacity
+ */
+static int resizeIdIndex(IdIndex *index, int capacity)
+{
+    IdSlot *old_slot = index->slot;
+    int old_capacity = index->capacity;
+    int pos, index_pos;
+
+    index->slot = calloc(capacity, sizeof(*index->slot));
+    if (index->slot == NULL) {
+        index->slot = old_slot;
+        logError(ERROR_MEMORY_ALLOC);
+        return -1;
+    }
+
+    index->capacity = capacity;
+
+    for (pos = 0; pos < old_capacity; pos++) {
+        if (old_slot[pos].id == EMPTY_ID)
+            continue;
+
+        index_pos = HASH_ID(old_slot[pos].id, capacity);
+
+        while (index->slot[index_pos].id != EMPTY_ID)
+            index_pos = (index_pos + 1) & (capacity - 1);
+
+        index->slot[index_pos] = old_slot[pos];
+    }
+
+    free(old_slot);
+
+    return 0;
+}
@@ -0,0 +1,243 @@
+/*
+ * importReader.c
+ *
+ * Reader of the records from a csv file (columns same as the export),
+ * file is read in large chunks and parsed in one pass
+ *
+ *  Created on: 16-Oct-2026
+ *      Author: deepaks
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "headers/importReader.h"
+#include "headers/recordFunction.h"
+#include "headers/customError.h"
+
+/* returned by nextChar(), when the file is completely read */
+#define END_OF_FILE     -1
+
+
+static int readFields(ImportReader *reader);
+static int nextChar(ImportReader *reader);
+static int recordType(const char *type);
+
+
+/*
+ * Function to open the csv file to read the records
+ *
+ * Return = 0, indicates success
+ * Return > 0, indicates file cannot be opened
+ * Return < 0, indicates error
+ */
+int openImportReader(ImportReader *reader, const char *path)
+{
+    if (reader == NULL || path == NULL) {
+        logError(ERROR_FUNC_ARG);
+        return -2;
+    }
+
+    memset(reader, 0, sizeof(*reader));
+
+    reader->fp = fopen(path, "rb");
+    if (reader->fp == NULL)
+        return 1;
+
+    reader->buffer = malloc(IMPORT_BUFFER_SIZE);
+    if (reader->buffer == NULL) {
+        logError(ERROR_MEMORY_ALLOC);
+        fclose(reader->fp);
+        reader->fp = NULL;
+        return -1;
+    }
+
+    return 0;
+}
+
+
+/*
+ * Function to read the next record from the file
+ * header line (first field 'id') and empty lines are skipped,
+ * id of the record is not read (it is given when the record is added)
+ *
+ * Return = 0, indicates record is read
+ * Return = 1, indicates no more records
+ * Return = 2, indicates invalid record (line no is kept in reader->line)
+ * Return < 0, indicates error
+ */
+int readImportRecord(ImportReader *reader, Record *rec)
+{
+    char (*field)[IMPORT_FIELD_LEN];
+    int fields;
+
+    if (reader == NULL || reader->fp == NULL || rec == NULL) {
+        logError(ERROR_FUNC_ARG);
+        return -2;
+    }
+
+    field = reader->field;
+
+    do {
+        reader->line = reader->newlines + 1;
+
+        fields = readFields(reader);
+        if (fields < -1)
+            return -1;
+
+        if (fields == 0)
+            return 1;
+    } while ((fields == 1 && field[0][0] == '\0')
+            || (reader->line == 1 && strcmp(field[0], "id") == 0));
+
+    if (fields != IMPORT_FIELDS)
+        return 2;
+
+    memset(rec, 0, sizeof(*rec));
+
+    rec->r_info = recordType(field[1]);
+
+    if (rec->r_info < 0 || parseStringToAmount(field[2], &rec->r_amount) != 0
+            || parseStringToDate(field[3], &rec->r_date) != 0
+            || strlen(field[4]) >= ENTITY_LEN)
+        return 2;
+
+    strcpy(rec->r_entity, field[4]);
+    strcpy(rec->r_comment, field[5]);
+
+    return 0;
+}
+
+
+/*
+ * To close the file and free the buffer
+ */
+void closeImportReader(ImportReader *reader)
+{
+    if (reader == NULL)
+        return;
+
+    if (reader->fp != NULL)
+        fclose(reader->fp);
+
+    free(reader->buffer);
+    memset(reader, 0, sizeof(*reader));
+}
+
+
+/*
+ * Function to read the fields of a record (a line, except the line breaks
+ * within quotes) into reader->field, quoted field can have comma, quote
+ * (as two quotes) and line breaks
+ *
+ * Return > 0, no of fields
+ * Return = 0, indicates end of file
+ * Return = -1, indicates a field is too long or too many fields
+ * Return < -1, indicates read error
+ */
+static int readFields(ImportReader *reader)
+{
+    int ch, length = 0, fields = 0;
+    int quoted = 0, invalid = 0;
+
+    ch = nextChar(reader);
+    if (ch == END_OF_FILE)
+        return (ferror(reader->fp)) ? -2 : 0;
+
+    reader->field[0][0] = '\0';
+
+    for (; ch != END_OF_FILE; ch = nextChar(reader)) {
+        if (ch == '\n')
+            reader->newlines++;
+
+        if (quoted) {
+            if (ch != '"') {
+                /* character is added below */
+            } else if ((ch = nextChar(reader)) == '"') {
+                /* two quotes within quotes, as one quote */
+            } else {
+                quoted = 0;
+
+                if (ch == END_OF_FILE)
+                    break;
+
+                if (ch == '\n')
+                    reader->newlines++;
+            }
+        }
+
+        if (quoted == 0) {
+            if (ch == '\n')
+                break;
+
+            if (ch == '\r')
+                continue;
+
+            if (ch == '"' && length == 0) {
+                quoted = 1;
+                continue;
+            }
+
+            if (ch == ',') {
+                reader->field[fields][length] = '\0';
+                length = 0;
+
+                if (++fields == IMPORT_FIELDS) {
+                    invalid = 1;
+                    fields--;
+                }
+
+                reader->field[fields][0] = '\0';
+                continue;
+            }
+        }
+
+        if (length < IMPORT_FIELD_LEN - 1) {
+            reader->field[fields][length++] = (char) ch;
+        } else {
+            invalid = 1;
+        }
+    }
+
+    if (ferror(reader->fp))
+        return -2;
+
+    reader->field[fields][length] = '\0';
+
+    return (invalid) ? -1 : fields + 1;
+}
+
+
+/*
+ * To get the next character of the file, buffer is filled when empty
+ */
+static int nextChar(ImportReader *reader)
+{
+    if (reader->offset == reader->length) {
+        reader->length = fread(reader->buffer, 1, IMPORT_BUFFER_SIZE, reader->fp);
+        reader->offset = 0;
+
+        if (reader->length == 0)
+            return END_OF_FILE;
+    }
+
+    return (unsigned char) reader->buffer[reader->offset++];
+}
+
+
+/*
+ * To get the info of the record from type (income/in or expense/ex)
+ *
+ * Return < 0, indicates invalid type
+ */
+static int recordType(const char *type)
+{
+    if (strcmp(type, "income") == 0 || strcmp(type, "in") == 0)
+        return 1;
+
+    if (strcmp(type, "expense") == 0 || strcmp(type, "ex") == 0)
+        return 0;
+
+    return -1;
+}
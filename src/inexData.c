@@ -11,20 +11,49 @@
 #include <stdlib.h>
 #include <string.h>
 #include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #include "headers/inexData.h"
 #include "headers/customError.h"
 #include "headers/recordFunction.h"
+#include "headers/recordStore.h"
+#include "headers/journal.h"
+#include "headers/rollup.h"
+#include "headers/filterProgram.h"
+#include "headers/scanKernel.h"
+#include "headers/workerPool.h"
+#include "headers/textIndex.h"
+#include "headers/groupTable.h"
+#include "headers/topHeap.h"
+#include "headers/resultCache.h"
+#include "headers/exportWriter.h"
+#include "headers/importReader.h"
 
 #define HEADER_LEN      32
 #define FOOTER_LEN      32
 #define FILE_NAME_LEN   32
 
-/* Incomplete Datatype */
-typedef struct listNode* ListNodePtr;
+/* journal is compacted into the InEx file, when it has more entries than this */
+#define JOURNAL_COMPACT_MIN     4096
+
+/* number of records in a page of 'view' */
+#define VIEW_PAGE_SIZE          15
+
+/* rows of a filter to be shown (limit < 0, for all the rows) */
+struct rowLimit {
+    int             offset;
+    int             limit;
+    StoreTotals     totals;     /* of the rows shown */
+};
 
 /* Function Pointer type definition for filter functions */
-typedef int (*FilterFunction)(InexDataPtr inex, char **token);
+typedef int (*FilterFunction)(InexDataPtr inex, char **token,
+        const struct rowLimit *limit);
 
 struct metaData {
     char    md_header[HEADER_LEN];
@@ -36,14 +65,38 @@ struct metaData {
     char    md_footer[FOOTER_LEN];
 };
 
-struct listNode {
-    Record              rec;
-    struct listNode     *next;
+/* Background backup of the InEx Data, written from a snapshot */
+struct inexBackup {
+    pthread_t       thread;
+    int             running;
+    atomic_int      done;       /* set by the backup thread at the end */
+    int             result;
+    int             written;    /* backup file is written atleast once */
+    struct metaData meta;
+    StoreSnapshot   snapshot;
+    Rollup          rollup;
 };
 
 struct inexData {
     struct metaData meta;
-    ListNodePtr     headNode;
+    RecordStore     store;
+    Rollup          rollup;     /* per month and per year totals */
+
+    /* trigrams of entity and comment, built on the first search */
+    TextIndex       text_index;
+    int             text_indexed;
+
+    /* results of the recent scans, valid only for the same generation */
+    ResultCache     result_cache;
+
+    /* changes after the last complete write of the InEx file */
+    Journal         journal;
+    int             full_save;  /* journal alone is not enough for next save */
+
+    /* generation is incremented for every change of the records */
+    long            generation;
+    long            backup_generation;
+    struct inexBackup backup;
 };
 
 /* Lookup template for filter based on fieldName */
@@ -52,23 +105,170 @@ typedef struct {
     FilterFunction  filter;
 } FilterLookup;
 
+/* function called for the selected records of every leaf of a scan, in order */
+typedef void (*LeafVisitor)(const StoreLeaf *leaf, const uint64_t *mask,
+        void *context);
+
+/* no of leaves selected by a task of the scan */
+#define LEAVES_PER_TASK     16
+
+/*
+ * Leaves covered by a scan (latest leaf first), selected in parallel
+ * by the worker pool, every task keeps its own totals
+ */
+struct leafScan {
+    const FilterProgram *program;
+    const StoreLeaf     **leaf;
+    uint64_t            (*mask)[MASK_WORDS(LEAF_CAPACITY)];
+    StoreTotals         *partial;
+    int                 count;
+    int                 capacity;
+};
+
+/* final change of a record in journal, over the record in file */
+#define OVERLAY_EDIT        1   /* changed in the same position */
+#define OVERLAY_MOVE        2   /* added or moved after the same dates */
+#define OVERLAY_DELETE      3
+
+struct overlayRecord {
+    int                 operation;  /* journal entry (while loading) */
+    int                 state;
+    int                 seq;        /* position of the entry in journal */
+    Record              rec;
+};
+
+/*
+ * Changes of the journal over the records of a file (to query the file)
+ * records sorted by id, and the records placed by the journal
+ * sorted by date (and by the order they are placed)
+ */
+struct journalOverlay {
+    struct overlayRecord    *entry;
+    int                     count;
+    int                     capacity;
+    struct overlayRecord    **moved;
+    int                     moved_count;
+};
+
 
 static int readInexDataFromFile(InexDataPtr inex, FILE *fp);
+static int readLegacyRecords(InexDataPtr inex, FILE *fp);
+static int readV2Records(InexDataPtr inex, FILE *fp);
+static int mapInexDataFromFile(InexDataPtr inex, const char *completeFileName);
+static int loadLegacyRecords(InexDataPtr inex, const Record *records, int count);
+static int loadV2Records(InexDataPtr inex, const void *columns, size_t length);
+static int buildRollup(InexDataPtr inex);
+static void printRollupBucket(const RollupBucket *bucket, int monthly);
 static int writeInexDataIntoFile(InexDataPtr inex, FILE *fp);
+static int compactInexData(InexDataPtr inex, const char *completeFileName,
+        const char *journalFileName);
+static int replayJournalEntry(void *context, int operation, const Record *rec);
+static void metaApplyRecord(InexDataPtr inex, const Record *rec, int sign);
+static void *backupThread(void *argument);
+static int finishBackup(InexDataPtr inex, int wait);
 static int isValidFileName(const char *fileName);
 static int fileExist(const char *fileName);
-static int metaUpdate(InexDataPtr inex, ListNodePtr node, Record *rec);
-static int insertListNode(InexDataPtr inex, ListNodePtr node);
-static int updateListNode(ListNodePtr node, Record *rec);
+static int metaUpdate(InexDataPtr inex, const Record *old, const Record *rec);
+static int updateRecordFields(Record *dest, const Record *rec);
 
-/* filter related functions */
-static int filterByDate(InexDataPtr inex, char **token);
-static int filterByAmount(InexDataPtr inex, char **token);
+/* view related functions */
+static int locateCursor(InexDataPtr inex, int record_id, DateKey key,
+        StorePos *pos);
+static void printPage(ViewCursor *cursor, StorePos *pos);
 
+/* search related functions */
+static int buildTextIndex(InexDataPtr inex);
+static void dropTextIndex(InexDataPtr inex);
+static int allRecordIds(InexDataPtr inex, int **ids, int *count);
+static int compareId(const void *a, const void *b);
 
-static const char *header_name = "inex-file-header";
+/* filter related functions */
+static int filterByDate(InexDataPtr inex, char **token,
+        const struct rowLimit *limit);
+static int filterByAmount(InexDataPtr inex, char **token,
+        const struct rowLimit *limit);
+static int filterByExpression(InexDataPtr inex, char **token,
+        const struct rowLimit *limit);
+static int cutRowLimit(char **token, struct rowLimit *limit);
+static int scanFilterRows(InexDataPtr inex, const FilterProgram *program,
+        const struct rowLimit *limit, StoreTotals *totals);
+static void printLimitedRecords(const StoreLeaf *leaf, const uint64_t *mask,
+        void *context);
+static int scanRecords(InexDataPtr inex, const FilterProgram *program,
+        LeafVisitor visit, void *context, StoreTotals *totals);
+static int collectScanLeaves(InexDataPtr inex, struct leafScan *scan);
+static void scanLeafTask(void *context, int task);
+static void freeLeafScan(struct leafScan *scan);
+static void printSelectedRecords(const StoreLeaf *leaf, const uint64_t *mask,
+        void *context);
+static void groupSelectedRecords(const StoreLeaf *leaf, const uint64_t *mask,
+        void *context);
+static void pushSelectedRecords(const StoreLeaf *leaf, const uint64_t *mask,
+        void *context);
+static void printTotalsRow(const char *name, int width, int count, long income,
+        long expense);
+static void printGroupSeperator(int width);
+
+/* query related functions */
+static int loadJournalOverlay(struct journalOverlay *overlay,
+        const char *journalFileName);
+static int overlayJournalEntry(void *context, int operation, const Record *rec);
+static void applyOverlay(struct overlayRecord *record,
+        const struct overlayRecord *change);
+static const struct overlayRecord *findOverlay(
+        const struct journalOverlay *overlay, int record_id);
+static void freeJournalOverlay(struct journalOverlay *overlay);
+static int compareOverlay(const void *a, const void *b);
+static int compareMoved(const void *a, const void *b);
+static int streamRecords(FILE *fp, int count, const FilterProgram *program,
+        const struct journalOverlay *overlay, StoreTotals *totals);
+static void queryMovedRecords(const FilterProgram *program,
+        const struct journalOverlay *overlay, int *moved, DateKey key,
+        StoreTotals *totals);
+static int matchRecord(const FilterProgram *program, const Record *rec);
+static void printQueryRecord(const Record *rec, StoreTotals *totals);
+
+/* export related functions */
+static int exportLeafRecords(ExportWriter *writer, const StoreLeaf *leaf,
+        const uint64_t *mask);
+
+/* import related functions */
+static int readImportBatch(InexDataPtr inex, ImportReader *reader,
+        Record **batch, int *count);
+static int mergeImportBatch(InexDataPtr inex, Record *batch, int count);
+static int compareImportKey(const void *a, const void *b);
+
+
+static const char *header_name = "inex-file-header-v4";
 static const char *footer_name = "inex-file-footer";
 
+/* header of the files with records stored one after another (BETA 0.9.3) */
+static const char *legacy_header_name = "inex-file-header";
+
+/* header of the files with column of Date (instead of packed date key) */
+static const char *v2_header_name = "inex-file-header-v2";
+
+/* header of the files without rollups after the columns */
+static const char *v3_header_name = "inex-file-header-v3";
+
+static const char *summary_header = 
+    "\n\t<------SUMMARY------>\n";
+static const char *summary_column_text = 
+    "  PERIOD | RECORDS |          INCOME |         EXPENSE |         BALANCE";
+static const char *summary_seperator_text = 
+    "---------|---------|-----------------|-----------------|-----------------";
+
+static const char *group_header = 
+    "\n\t<------GROUP------>\n";
+static const char *group_column_text = 
+    " | RECORDS |          INCOME |         EXPENSE |         BALANCE";
+static const char *group_seperator_text = 
+    "|---------|-----------------|-----------------|-----------------";
+
+/* field names of group, indexed by GROUP_ENTITY till GROUP_TYPE */
+static const char *group_field[] = {NULL, "entity", "month", "year", "type"};
+static const char *group_column[] = {NULL, "ENTITY", "MONTH", "YEAR", "TYPE"};
+
 /* Declaring static Lookup table for filter */
 static const FilterLookup filter_lookup[] = {
     {"date"     , filterByDate},
@@ -120,7 +320,12 @@ InexDataPtr createInexData(const char *fileName)
     inex->meta.md_record_count  = 0;
     inex->meta.md_total_income  = 0;
     inex->meta.md_total_expense = 0;
-    inex->headNode              = NULL;
+    initRecordStore(&inex->store);
+    initRollup(&inex->rollup);
+    initTextIndex(&inex->text_index);
+    initResultCache(&inex->result_cache);
+    initJournal(&inex->journal);
+    inex->full_save = 1;
 
     return inex;
 }
@@ -136,6 +341,8 @@ InexDataPtr openInexDataFromFile(const char *fileName)
     FILE *fp;
     InexDataPtr inex;
     char completeFileName[FILE_NAME_LEN];
+    char journalFileName[FILE_NAME_LEN];
+    int returnCode;
 
     if (fileName == NULL) {
         logError(ERROR_FUNC_ARG);
@@ -156,26 +363,59 @@ InexDataPtr openInexDataFromFile(const char *fileName)
         return NULL;
     }
 
-    fp = fopen(completeFileName,"rb");
-
-    if (fp == NULL) {
-        logError(ERROR_FILE_OPEN);
-        return NULL;
-    }
-
     inex = calloc(1, sizeof(*inex));
     if (inex == NULL) {
         logError(ERROR_MEMORY_ALLOC);
-        goto end_open;
+        return NULL;
+    }
+
+    initRecordStore(&inex->store);
+    initRollup(&inex->rollup);
+    initTextIndex(&inex->text_index);
+    initResultCache(&inex->result_cache);
+    initJournal(&inex->journal);
+
+    /* 
+     * Map the file, so that opening is independent of the no of records
+     * returnCode > 0, indicates mapping is not possible, so read the file
+     */
+    returnCode = mapInexDataFromFile(inex, completeFileName);
+
+    if (returnCode > 0) {
+        fp = fopen(completeFileName,"rb");
+
+        if (fp == NULL) {
+            logError(ERROR_FILE_OPEN);
+            destroyInexData(inex);
+            return NULL;
+        }
+
+        returnCode = readInexDataFromFile(inex, fp);
+        fclose(fp);
     }
 
-    if (readInexDataFromFile(inex, fp) != 0) {
+    if (returnCode != 0) {
         destroyInexData(inex);
-        inex = NULL;
+        return NULL;
     }
 
-end_open:
-    fclose(fp);
+    /* 
+     * apply the changes saved after the last complete write of the file
+     * broken journal (partly written) is compacted on the next save
+     */
+    strncpy(journalFileName, inex->meta.md_file_name, FILE_NAME_LEN);
+    strncat(journalFileName, ".jnl", 5);
+
+    returnCode = replayJournal(&inex->journal, journalFileName, 
+        replayJournalEntry, inex);
+
+    if (returnCode < 0) {
+        destroyInexData(inex);
+        return NULL;
+    }
+
+    if (returnCode > 0)
+        inex->full_save = 1;
 
     return inex;
 }
@@ -200,14 +440,52 @@ int infoInexData(InexDataPtr inex)
 }
 
 
+/*
+ * Function to verify the totals of the meta data, 
+ * against a (parallel) scan of all the records
+ *
+ * Return = 0, indicates totals are matching
+ * Return > 0, indicates totals are not matching
+ * Return < 0, indicates error
+ */
+int verifyInexData(InexDataPtr inex)
+{
+    FilterProgram program;
+    StoreTotals totals;
+
+    if (inex == NULL) {
+        logError(ERROR_FUNC_ARG);
+        return -2;
+    }
+
+    /* every record has a date key within this range */
+    rangeFilter(&program, FILTER_DATE, 0, INT_MAX);
+
+    if (scanRecords(inex, &program, NULL, NULL, &totals) != 0)
+        return -1;
+
+    if (totals.count != inex->meta.md_record_count
+            || totals.income != inex->meta.md_total_income
+            || totals.expense != inex->meta.md_total_expense)
+        return 1;
+
+    return 0;
+}
+
+
 /*
  * Function to save the InEx Data as binary file (.bin)
+ *
+ * Changes after the last save are appended into the journal (.jnl),
+ * so the cost of a save depends only on the no of changes.
+ * The complete file is written (and journal removed) for a new file,
+ * or when the journal becomes larger than the file.
  */
 int saveInexData(InexDataPtr inex) 
 {
-    FILE *fp;
     char completeFileName[FILE_NAME_LEN];
-    int returnCode;
+    char journalFileName[FILE_NAME_LEN];
+    long journal_entries;
 
     if (inex == NULL) {
         logError(ERROR_FUNC_ARG);
@@ -223,22 +501,76 @@ int saveInexData(InexDataPtr inex)
     strncpy(completeFileName, inex->meta.md_file_name, FILE_NAME_LEN);
     strncat(completeFileName, ".bin", 5);
 
-    fp = fopen(completeFileName, "wb");
-    if (fp == NULL) {
-        logError(ERROR_FILE_OPEN);
-        return -3;
+    strncpy(journalFileName, inex->meta.md_file_name, FILE_NAME_LEN);
+    strncat(journalFileName, ".jnl", 5);
+
+    journal_entries = inex->journal.file_entries + inex->journal.count;
+
+    if (inex->full_save || inex->journal.lost 
+            || (journal_entries > JOURNAL_COMPACT_MIN 
+                && journal_entries > inex->store.count)) {
+        return compactInexData(inex, completeFileName, journalFileName);
     }
 
-    returnCode = writeInexDataIntoFile(inex, fp);
-    if (returnCode != 0) {
-        removeInexFile(inex->meta.md_file_name);
-        fclose(fp);
-        return returnCode;
+    if (flushJournal(&inex->journal, journalFileName) != 0)
+        return -1;
+
+    inex->backup_generation = inex->generation;
+
+    return 0;
+}
+
+
+/*
+ * Function to write a temporary backup (.bak) of the InEx Data in background
+ * records are taken from a snapshot of the store, so that the changes 
+ * can continue while the backup is written
+ *
+ * Return = 0, indicates backup started
+ * Return > 0, indicates previous backup is running or no changes to backup
+ * Return < 0, indicates error
+ */
+int backupInexData(InexDataPtr inex)
+{
+    struct inexBackup *backup;
+
+    if (inex == NULL) {
+        logError(ERROR_FUNC_ARG);
+        return -2;
     }
 
-    fclose(fp);
+    backup = &inex->backup;
 
-    return returnCode;
+    if (finishBackup(inex, 0) != 0)
+        return 1;
+
+    if (inex->generation == inex->backup_generation)
+        return 2;
+
+    backup->meta                    = inex->meta;
+    backup->meta.md_record_count    = inex->store.count;
+
+    if (inex->rollup.lost && buildRollup(inex) != 0)
+        return -1;
+
+    if (copyRollup(&backup->rollup, &inex->rollup) != 0)
+        return -1;
+
+    if (snapshotRecordStore(&inex->store, &backup->snapshot) != 0)
+        return -1;
+
+    atomic_store(&backup->done, 0);
+
+    if (pthread_create(&backup->thread, NULL, backupThread, backup) != 0) {
+        logError(ERROR_WENT_WRONG);
+        releaseStoreSnapshot(&inex->store, &backup->snapshot);
+        return -1;
+    }
+
+    backup->running         = 1;
+    inex->backup_generation = inex->generation;
+
+    return 0;
 }
 
 
@@ -250,24 +582,27 @@ int saveInexData(InexDataPtr inex)
  */
 void destroyInexData(InexDataPtr inex) 
 {
-    ListNodePtr current_node;
-    ListNodePtr previous_node;
+    char backupFileName[FILE_NAME_LEN];
 
     if (inex == NULL)
         return;
 
-    if (inex->headNode != NULL) 
-    {
-        current_node = inex->headNode;
+    finishBackup(inex, 1);
 
-        while(current_node != NULL) 
-        {
-            previous_node = current_node;
-            current_node = current_node->next;
-            free(previous_node);
-        }
+    /* temporary backup is needed only while the file is opened */
+    if (inex->backup.written) {
+        strncpy(backupFileName, inex->meta.md_file_name, FILE_NAME_LEN);
+        strncat(backupFileName, ".bak", 5);
+        remove(backupFileName);
     }
 
+    freeRecordStore(&inex->store);
+    freeRollup(&inex->rollup);
+    freeRollup(&inex->backup.rollup);
+    freeTextIndex(&inex->text_index);
+    freeResultCache(&inex->result_cache);
+    freeJournal(&inex->journal);
+
     free(inex);
 }
 
@@ -278,6 +613,7 @@ void destroyInexData(InexDataPtr inex)
 int removeInexFile(const char *fileName) 
 {
     char fileNameExtension[FILE_NAME_LEN];
+    char journalFileName[FILE_NAME_LEN];
 
     if (fileName == NULL) 
         return -2;
@@ -304,6 +640,15 @@ int removeInexFile(const char *fileName)
         return -1;
     }
 
+    /* journal of the file (if any) is not needed anymore */
+    strncpy(journalFileName, fileName, FILE_NAME_LEN);
+    strncat(journalFileName, ".jnl", 5);
+
+    if (fileExist(journalFileName) && remove(journalFileName) != 0) {
+        logError(ERROR_FILE_REMOVE);
+        return -1;
+    }
+
     return 0;
 }
 
@@ -321,6 +666,110 @@ void listInexFile()
 }
 
 
+/*
+ * Function to filter the records of a saved file, without opening it
+ * columns are read in chunks from the latest record, and the changes in
+ * its journal are applied on the way, so the memory needed does not
+ * depend on the no of records in file (but grows with the no of entries
+ * in its journal, which are all loaded; save compacts the journal into
+ * the file, once it has more entries than the file has records)
+ *
+ * Return = 0, indicates success
+ * Return = 1, indicates invalid filter expression
+ * Return > 1, indicates file cannot be queried
+ * Return < 0, indicates error
+ */
+int queryInexFile(const char *fileName, char **token)
+{
+    struct metaData meta;
+    struct journalOverlay overlay;
+    FilterProgram program;
+    StoreTotals totals;
+    char completeFileName[FILE_NAME_LEN];
+    char journalFileName[FILE_NAME_LEN];
+    FILE *fp;
+    int returnCode;
+
+    if (fileName == NULL || token == NULL) {
+        logError(ERROR_FUNC_ARG);
+        return -2;
+    }
+
+    if (isValidFileName(fileName) == 0) {
+        puts("\tMESSAGE: Invalid FileName!");
+        return 2;
+    }
+
+    if (compileFilter(&program, token) != 0)
+        return 1;
+
+    strncpy(completeFileName, fileName, FILE_NAME_LEN);
+    strncat(completeFileName, ".bin", 5);
+
+    strncpy(journalFileName, fileName, FILE_NAME_LEN);
+    strncat(journalFileName, ".jnl", 5);
+
+    if (fileExist(completeFileName) == 0) {
+        puts("\tMESSAGE: File doesn't exist!");
+        return 2;
+    }
+
+    fp = fopen(completeFileName, "rb");
+    if (fp == NULL) {
+        logError(ERROR_FILE_OPEN);
+        return -1;
+    }
+
+    if (fread(&meta, sizeof(meta), 1, fp) != 1) {
+        logError(ERROR_FILE_READ);
+        fclose(fp);
+        return -1;
+    }
+
+    /* old files are not sorted by date column, they are converted on save */
+    if (strncmp(meta.md_header, legacy_header_name, HEADER_LEN) == 0
+            || strncmp(meta.md_header, v2_header_name, HEADER_LEN) == 0) {
+        puts("\tMESSAGE: Old InEx file, open and save it once to query!");
+        fclose(fp);
+        return 3;
+    }
+
+    if ((strncmp(meta.md_header, header_name, HEADER_LEN) != 0 
+                && strncmp(meta.md_header, v3_header_name, HEADER_LEN) != 0)
+            || meta.md_record_count < 0) {
+        puts("\tMESSAGE: Not a valid InEx file!");
+        fclose(fp);
+        return 3;
+    }
+
+    memset(&overlay, 0, sizeof(overlay));
+
+    if (loadJournalOverlay(&overlay, journalFileName) != 0) {
+        freeJournalOverlay(&overlay);
+        fclose(fp);
+        return -1;
+    }
+
+    printRecordHeaderInConsole();
+
+    returnCode = streamRecords(fp, meta.md_record_count, &program, &overlay,
+        &totals);
+
+    freeJournalOverlay(&overlay);
+    fclose(fp);
+
+    if (returnCode != 0)
+        return -1;
+
+    flushRecordsInConsole();
+    puts("");
+    printCalculationInConsole(totals.count, totals.income, totals.expense);
+    printRecordFooterInConsole();
+
+    return 0;
+}
+
+
 /*
  * Function to add record into into InEx Data
  * record with latest date should be added on Top (head)
@@ -329,7 +778,6 @@ void listInexFile()
  */
 int addRecord(InexDataPtr inex, Record *rec) 
 {
-    ListNodePtr node;
     int remaining_id        = 0;
     long remaining_income   = 0;
     long remaining_expense  = 0;
@@ -354,16 +802,13 @@ int addRecord(InexDataPtr inex, Record *rec)
         return 2;
     }
 
-    node = calloc(1, sizeof(*node));
-    if (node == NULL) {
-        logError(ERROR_MEMORY_ALLOC);
+    rec->r_id = inex->meta.md_counter;
+
+    if (insertStoreRecord(&inex->store, rec) < 0)
         return -1;
-    }
 
+    inex->meta.md_counter++;
     inex->meta.md_record_count++;
-    rec->r_id   = inex->meta.md_counter++;
-    node->next  = NULL;
-    copyRecord(&node->rec, rec);
 
     if (rec->r_info & 1) {
         inex->meta.md_total_income += rec->r_amount;
@@ -371,7 +816,19 @@ int addRecord(InexDataPtr inex, Record *rec)
         inex->meta.md_total_expense += rec->r_amount;
     } 
 
-    return insertListNode(inex, node);
+    /* if it fails, rollup is marked as lost and built again when needed */
+    applyRollup(&inex->rollup, DATE_KEY(rec->r_date), rec->r_info, rec->r_amount, 1);
+
+    /* if it fails, index is dropped and built again on the next search */
+    if (inex->text_indexed && addTextIndex(&inex->text_index, rec->r_id,
+            rec->r_entity, rec->r_comment) != 0)
+        dropTextIndex(inex);
+
+    /* if it fails, journal is marked as lost and file is compacted on save */
+    appendJournal(&inex->journal, JOURNAL_ADD, rec);
+    inex->generation++;
+
+    return 0;
 } 
 
 
@@ -386,8 +843,8 @@ int addRecord(InexDataPtr inex, Record *rec)
  */
 int editRecord(InexDataPtr inex, Record *rec) 
 {
-    ListNodePtr current;
-    ListNodePtr next;
+    Record current, old;
+    StorePos pos;
     int no_of_field_updated = 0;
 
     if (inex == NULL || rec == NULL) {
@@ -399,62 +856,66 @@ int editRecord(InexDataPtr inex, Record *rec)
     if (rec->r_id >= inex->meta.md_counter) 
         return 1;
 
-    if (inex->headNode == NULL)
+    if (findStoreRecord(&inex->store, rec->r_id, &pos) != 0)
         return 1;
 
-    current = inex->headNode;
+    getStoreRecord(&pos, &current);
 
-    /* if the first ListNode needs to be updated */
-    if (inex->headNode->rec.r_id == rec->r_id) {
-        metaUpdate(inex, inex->headNode, rec);
-        no_of_field_updated = updateListNode(inex->headNode, rec);
+    old = current;
 
-        if (no_of_field_updated <= 0)
-            return 2;
-
-        /* 
-         * if date field updated, change the position of record Node 
-         * by detaching Node from current position, and insert it again
-         */
-        if (isValidDate(&rec->r_date)) {
-            inex->headNode = current->next;
-            insertListNode(inex, current);
-        }
+    no_of_field_updated = updateRecordFields(&current, rec);
+    if (no_of_field_updated <= 0)
+        return 2;
 
-        return 0;
-    }
+    /* 
+     * if date field updated, change the position of the record
+     * by removing it from current position, and insert it again
+     * (old record is inserted back, if the new one cannot be inserted)
+     */
+    if (isValidDate(&rec->r_date)) {
+        if (removeStoreRecord(&inex->store, &pos) != 0)
+            return -1;
 
-    while(current != NULL) {
-        next = current->next;
+        if (insertStoreRecord(&inex->store, &current) != 0) {
+            inex->generation++;
 
-        /* if end reached (i.e., No ListNode found), just return */
-        if (next == NULL)
-            return 1;
+            /* record is lost, meta data is kept in sync with the store */
+            if (insertStoreRecord(&inex->store, &old) != 0) {
+                metaUpdate(inex, &old, NULL);
 
-        /* if middle or last ListNode needs to be updated*/
-        if (next->rec.r_id == rec->r_id) {
-            metaUpdate(inex, next, rec);
-            no_of_field_updated = updateListNode(next, rec);
+                if (inex->text_indexed)
+                    removeTextIndex(&inex->text_index, old.r_id, old.r_entity,
+                        old.r_comment);
 
-            if (no_of_field_updated <= 0)
-                return 2;
-            
-            /* 
-             * if date field updated, change the position of record Node
-             * by detaching Node from current position, and insert it again
-             */
-            if (isValidDate(&rec->r_date)) {
-                current->next = next->next;
-                insertListNode(inex, next);
+                appendJournal(&inex->journal, JOURNAL_DELETE, &old);
             }
 
-            return 0;
+            return -1;
         }
+    } else {
+        if (setStoreRecord(&inex->store, &pos, &current) != 0)
+            return -1;
+    }
 
-        current = current->next;
+    /* meta data, rollups and text index are changed only after the store */
+    metaUpdate(inex, &old, rec);
+
+    /* trigrams of the old entity and comment are replaced by the new ones */
+    if (inex->text_indexed && (strcmp(old.r_entity, current.r_entity) != 0
+            || strcmp(old.r_comment, current.r_comment) != 0)) {
+        removeTextIndex(&inex->text_index, old.r_id, old.r_entity, old.r_comment);
+
+        if (addTextIndex(&inex->text_index, current.r_id, current.r_entity,
+                current.r_comment) != 0)
+            dropTextIndex(inex);
     }
 
-    return 1;
+    inex->generation++;
+
+    appendJournal(&inex->journal, 
+        isValidDate(&rec->r_date) ? JOURNAL_EDIT_DATE : JOURNAL_EDIT, &current);
+
+    return 0;
 }
 
 
@@ -463,86 +924,136 @@ int editRecord(InexDataPtr inex, Record *rec)
  */
 int deleteRecord(InexDataPtr inex, int record_id)
 {
-    ListNodePtr current;
-    ListNodePtr temp;
+    Record current;
+    StorePos pos;
 
     if (inex == NULL || record_id < 0) {
         logError(ERROR_FUNC_ARG);
         return -2;
     }
 
-    current = inex->headNode;
-
     /* Existing ID are always lesser than current counter */
     if (record_id >= inex->meta.md_counter) 
         return 1;
 
-    /* if no existing records */
-    if (current == NULL)
+    if (findStoreRecord(&inex->store, record_id, &pos) != 0)
         return 1;
 
-    /* If matching record found in the start */
-    if (current->rec.r_id == record_id) {
-        /* update meta data */
-        metaUpdate(inex, current, NULL);
-
-        /* delete */
-        inex->headNode = current->next;
-        free(current);
+    getStoreRecord(&pos, &current);
 
-        return 0;
-    }
-    
-    while (current != NULL) {
-        /* If no matching records found */
-        if (current->next == NULL)
-            return 1;
-
-        /* If matching record found in the middle or end */
-        if (current->next->rec.r_id == record_id) {
-            /* update meta data */
-            metaUpdate(inex, current->next, NULL);
+    if (removeStoreRecord(&inex->store, &pos) != 0)
+        return -1;
 
-            /* delete */
-            temp = current->next;
-            current->next = temp->next;
-            free(temp);
+    /* meta data, rollups and text index are changed only after the store */
+    metaUpdate(inex, &current, NULL);
 
-            return 0;
-        }
+    if (inex->text_indexed)
+        removeTextIndex(&inex->text_index, current.r_id, current.r_entity,
+            current.r_comment);
 
-        current = current->next;
-    }
+    appendJournal(&inex->journal, JOURNAL_DELETE, &current);
+    inex->generation++;
 
-    return 1;
+    return 0;
 }
 
 
 /*
- * Function to view the records based on the arguments
- * all              - indicates all records
- * count (int)      - indicates no of latest records to view
- * if no arguments  - then latest 15 records will be shown
- * 
+ * Function to show the totals per period, read from the rollups
+ * if no arguments  - totals of every year
+ * year (yyyy)      - totals of every month of the year
+ * month (yyyy-mm)  - totals of the month
+ *
  * Can be viewed only in console 
  */
-int viewRecord(InexDataPtr inex, const char *argument)
+int summaryRecord(InexDataPtr inex, const char *argument)
 {
-    ListNodePtr current = inex->headNode;
-    int count       = 0;
+    const RollupList *list;
+    int year, month, first, last, index;
     int no_of_rec   = 0;
     long income     = 0;
     long expense    = 0;
+    char ch;
 
     if (inex == NULL) {
         logError(ERROR_FUNC_ARG);
         return -2;
     }
 
-    /*
-     * If no additional argument for 'view' command 
-     * show maximum of 15 records only 
-     */
+    if (inex->rollup.lost && buildRollup(inex) != 0)
+        return -1;
+
+    if (argument == NULL) {
+        list    = &inex->rollup.year;
+        first   = 0;
+        last    = list->count;
+    } else if (sscanf(argument, "%d-%d%c", &year, &month, &ch) == 2) {
+        if (year <= 0 || year > 9999 || month <= 0 || month > 12)
+            return 1;
+
+        list    = &inex->rollup.month;
+        first   = findRollup(list, (year << 4) | month);
+        last    = findRollup(list, ((year << 4) | month) + 1);
+    } else if (sscanf(argument, "%d%c", &year, &ch) == 1) {
+        if (year <= 0 || year > 9999)
+            return 1;
+
+        list    = &inex->rollup.month;
+        first   = findRollup(list, year << 4);
+        last    = findRollup(list, (year + 1) << 4);
+    } else {
+        return 1;
+    }
+
+    puts(summary_header);
+    puts(summary_seperator_text);
+    puts(summary_column_text);
+    puts(summary_seperator_text);
+
+    for (index = first; index < last; index++) {
+        printRollupBucket(&list->bucket[index], list == &inex->rollup.month);
+
+        no_of_rec   += list->bucket[index].count;
+        income      += list->bucket[index].income;
+        expense     += list->bucket[index].expense;
+    }
+
+    puts(summary_seperator_text);
+    puts("");
+    printCalculationInConsole(no_of_rec, income, expense);
+    puts("");
+
+    return 0;
+}
+
+
+/*
+ * Function to view the records based on the arguments
+ * all              - indicates all records
+ * count (int)      - indicates no of latest records to view
+ * if no arguments  - then latest 15 records will be shown
+ * 
+ * Can be viewed only in console 
+ */
+int viewRecord(InexDataPtr inex, const char *argument)
+{
+    Record current;
+    StorePos pos;
+    int found;
+    int count       = 0;
+    int no_of_rec   = 0;
+    long income     = 0;
+    long expense    = 0;
+
+    if (inex == NULL) {
+        logError(ERROR_FUNC_ARG);
+        return -2;
+    }
+
+    /*
+     * If no additional argument for 'view' command 
+     * show maximum of 15 records only 
+     */
     if (argument == NULL) {
         count = 15;
     } else {
@@ -559,20 +1070,22 @@ int viewRecord(InexDataPtr inex, const char *argument)
     printRecordHeaderInConsole();
 
     /* 
-     * loop through all the records from the head 
+     * loop through all the records from the latest (tail of the store)
      * terminate based on the count value 
      * if count value is -ve, show all 
      */
-    while(current != NULL && (count != 0)) {
+    found = lastStorePos(&inex->store, &pos);
+
+    for (; found == 0 && (count != 0); found = prevStorePos(&pos)) {
         no_of_rec++;
-        if (current->rec.r_info & 1) {
-            income += current->rec.r_amount;
+        if (pos.leaf->info[pos.index] & 1) {
+            income += pos.leaf->amount[pos.index];
         } else {
-            expense += current->rec.r_amount;
+            expense += pos.leaf->amount[pos.index];
         }
 
-        printRecordInConsole(&current->rec);
-        current = current->next;
+        getStoreRecord(&pos, &current);
+        printRecordInConsole(&current);
         if (count > 0)
             count--;
     }
@@ -587,507 +1100,2572 @@ int viewRecord(InexDataPtr inex, const char *argument)
 
 
 /*
- * Generic Filter function to call the specific filter function 
- * based on the fieldName mentioned by the user
+ * Function to view a page of records, continuing from the cursor
+ * direction - "next" (older records), "prev" (newer records),
+ *             "from" (from the date or id of argument), NULL for the latest
+ *
+ * page starts from the record of the cursor (found by id), so every page
+ * costs O(page size), wherever it is within the store
  */
-int filterRecord(InexDataPtr inex, char **token)
+int pageRecord(InexDataPtr inex, ViewCursor *cursor, const char *direction,
+        const char *argument)
 {
-    int index = 0;
+    StorePos pos, newer;
+    Date date;
+    int found, count, record_id;
+    char ch;
 
-    if (inex == NULL || token == NULL) {
+    if (inex == NULL || cursor == NULL) {
         logError(ERROR_FUNC_ARG);
         return -2;
     }
 
-    /* First token should be 'filter' */
-    if (token[0] == NULL || strcmp(token[0], "filter") != 0) {
-        logError(ERROR_WENT_WRONG);
-        return -1;
-    }
+    if (direction == NULL || (cursor->valid == 0
+            && strcmp(direction, "from") != 0)) {
+        found = lastStorePos(&inex->store, &pos);
 
-    /* loop through filter lookup */
-    while (filter_lookup[index].fieldName != NULL) {
-        if (token[1] == NULL) 
+    } else if (strcmp(direction, "next") == 0) {
+        found = locateCursor(inex, cursor->last_id, cursor->last_key, &pos);
+
+        if (found < 0)
             return -1;
 
-        /* 
-         * if the 2nd token matches with the filter lookup fieldName 
-         * call the corresponding filter function based on fiedlName
-         */
-        if (strcmp(filter_lookup[index].fieldName, token[1]) == 0) {
-            return filter_lookup[index].filter(inex, token);
+        if (found == 0) {
+            found = prevStorePos(&pos);
+        } else {
+            /* record of cursor is not present, pos is older to it (if any) */
+            found = (found == 2);
         }
 
-        index++;
+    } else if (strcmp(direction, "prev") == 0) {
+        found = locateCursor(inex, cursor->first_id, cursor->first_key, &pos);
+
+        if (found < 0)
+            return -1;
+
+        if (found == 2) {
+            pos.leaf    = inex->store.head;
+            pos.index   = 0;
+            found       = (pos.leaf == NULL);
+        } else {
+            found = nextStorePos(&pos);
+        }
+
+        /* page ends at the record next to cursor, so start a page above */
+        for (count = 1; found == 0 && count < VIEW_PAGE_SIZE; count++) {
+            newer = pos;
+            if (nextStorePos(&newer) != 0)
+                break;
+            pos = newer;
+        }
+
+    } else {
+        if (argument == NULL) {
+            puts("\tMESSAGE: Invalid command arguments!");
+            return 1;
+        }
+
+        if (parseStringToDate(argument, &date) == 0) {
+            found = seekStoreDate(&inex->store, DATE_KEY(date), &pos);
+        } else if (sscanf(argument, "%d%c", &record_id, &ch) == 1
+                && record_id >= 0) {
+            found = findStoreRecord(&inex->store, record_id, &pos);
+            if (found < 0)
+                return -1;
+        } else {
+            puts("\tMESSAGE: Invalid command arguments!");
+            return 1;
+        }
     }
 
-    return 1;
-}
+    /* empty store, shown as an empty page */
+    if (found != 0 && direction == NULL)
+        return viewRecord(inex, "0");
 
+    if (found != 0) {
+        puts("\tMESSAGE: No more records!");
+        return 0;
+    }
 
-void showFileName(InexDataPtr inex) 
-{
-    if (inex == NULL)
-        return;
+    printPage(cursor, &pos);
 
-    printf("%s",inex->meta.md_file_name);
+    return 0;
 }
 
 
 /*
- * Function to read inex data from file 
+ * Function to find the position of the record of cursor
+ * (records of a date are in the order they are added, i.e. mostly by id)
+ *
+ * Return = 0, indicates pos is the record
+ * Return = 1, indicates record is not present, pos is the record older to it
+ * Return = 2, indicates record is not present, and no record is older to it
+ * Return < 0, indicates error
  */
-static int readInexDataFromFile(InexDataPtr inex, FILE *fp) 
+static int locateCursor(InexDataPtr inex, int record_id, DateKey key,
+        StorePos *pos)
 {
-    Record temp_record;
-    ListNodePtr temp_node;
-
-    if (inex == NULL || fp == NULL) {
-        logError(ERROR_FUNC_ARG);
-        return -2;
-    }
+    int returnCode;
 
-    if (fread(&inex->meta, sizeof(inex->meta), 1, fp) != 1) {
-        logError(ERROR_FILE_READ);
+    returnCode = findStoreRecord(&inex->store, record_id, pos);
+    if (returnCode < 0)
         return -1;
+
+    if (returnCode == 0 && pos->leaf->date_key[pos->index] == key)
+        return 0;
+
+    /* record is deleted or its date is edited, use its old place */
+    if (seekStoreDate(&inex->store, key, pos) != 0)
+        return 2;
+
+    while (pos->leaf->date_key[pos->index] == key
+            && pos->leaf->id[pos->index] >= record_id) {
+        if (prevStorePos(pos) != 0)
+            return 2;
     }
-    
-    while(fread(&temp_record, sizeof(temp_record), 1, fp) == 1) {
-        if (inex->headNode == NULL) {
-            temp_node = (ListNodePtr) calloc(1, sizeof(*temp_node));
 
-            if (temp_node == NULL) {
-                logError(ERROR_MEMORY_ALLOC);
-                return -1;
-            }
+    return 1;
+}
 
-            inex->headNode = temp_node;
-        } else {
-            temp_node->next = (ListNodePtr) calloc(1, sizeof(*temp_node));
 
-            if (temp_node->next == NULL) {
-                logError(ERROR_MEMORY_ALLOC);
-                return -1;
-            } 
+/*
+ * Function to print a page of records from pos (to the older records)
+ * cursor is moved to the page
+ */
+static void printPage(ViewCursor *cursor, StorePos *pos)
+{
+    Record current;
+    int found;
+    int no_of_rec   = 0;
+    long income     = 0;
+    long expense    = 0;
+
+    cursor->valid       = 1;
+    cursor->first_id    = pos->leaf->id[pos->index];
+    cursor->first_key   = pos->leaf->date_key[pos->index];
+
+    printRecordHeaderInConsole();
 
-            temp_node = temp_node->next;
+    for (found = 0; found == 0 && no_of_rec < VIEW_PAGE_SIZE;
+            found = prevStorePos(pos)) {
+        no_of_rec++;
+        if (pos->leaf->info[pos->index] & 1) {
+            income += pos->leaf->amount[pos->index];
+        } else {
+            expense += pos->leaf->amount[pos->index];
         }
 
-        copyRecord(&temp_node->rec, &temp_record);
-        temp_node->next = NULL;
+        cursor->last_id     = pos->leaf->id[pos->index];
+        cursor->last_key    = pos->leaf->date_key[pos->index];
+
+        getStoreRecord(pos, &current);
+        printRecordInConsole(&current);
     }
 
-    return 0;
-}
+    printRecordFooterInConsole();
 
+    printCalculationInConsole(no_of_rec, income, expense);
+    puts("");
+}
 
 /*
- * Function to write inex data into file 
+ * Function to search the text within entity and / or comment of records
+ * field - "entity" or "comment", NULL for both
+ *
+ * records having all the trigrams of text are taken from the text index,
+ * and checked for the text (every record is checked for shorter text)
+ * matching records are shown from the latest added record
  */
-static int writeInexDataIntoFile(InexDataPtr inex, FILE *fp) 
+int searchRecord(InexDataPtr inex, const char *field, const char *text)
 {
-    ListNodePtr current_node;
+    char pattern[COMMENT_LEN];
+    Record current;
+    StorePos pos;
+    int *ids;
+    int fields, count, index;
+    size_t length;
+    int returnCode;
 
-    if (inex == NULL || fp == NULL) {
+    /* for calculation based on the search output */
+    int no_of_rec   = 0;
+    long income     = 0;
+    long expense    = 0;
+
+    if (inex == NULL || text == NULL) {
         logError(ERROR_FUNC_ARG);
         return -2;
     }
 
-    if (fwrite(&inex->meta, sizeof(inex->meta), 1, fp) != 1) {
-        logError(ERROR_FILE_WRITE);
-        return -1;
+    if (field == NULL) {
+        fields = TEXT_ENTITY | TEXT_COMMENT;
+    } else if (strcmp(field, "entity") == 0) {
+        fields = TEXT_ENTITY;
+    } else if (strcmp(field, "comment") == 0) {
+        fields = TEXT_COMMENT;
+    } else {
+        return 1;
     }
 
-    current_node = inex->headNode;
+    /* text can be given within quotes ('text') */
+    if (text[0] == '\'')
+        text++;
 
-    while (current_node != NULL) {
-        if (fwrite(&current_node->rec, sizeof(current_node->rec), 1, fp) != 1) {
-            logError(ERROR_FILE_WRITE);
-            return -1;
+    length = strlen(text);
+
+    if (length > 0 && text[length - 1] == '\'')
+        length--;
+
+    if (length == 0 || length >= sizeof(pattern))
+        return 1;
+
+    memcpy(pattern, text, length);
+    pattern[length] = '\0';
+
+    if (inex->text_indexed == 0 && buildTextIndex(inex) != 0)
+        return -1;
+
+    returnCode = searchTextIndex(&inex->text_index, pattern, fields, &ids, &count);
+
+    if (returnCode > 0)
+        returnCode = allRecordIds(inex, &ids, &count);
+
+    if (returnCode != 0)
+        return -1;
+
+    printRecordHeaderInConsole();
+
+    for (index = count - 1; index >= 0; index--) {
+        if (findStoreRecord(&inex->store, ids[index], &pos) != 0)
+            continue;
+
+        getStoreRecord(&pos, &current);
+
+        if (((fields & TEXT_ENTITY) == 0 || strstr(current.r_entity, pattern) == NULL)
+                && ((fields & TEXT_COMMENT) == 0 
+                    || strstr(current.r_comment, pattern) == NULL))
+            continue;
+
+        no_of_rec++;
+
+        if (current.r_info & 1) {
+            income += current.r_amount;
+        } else {
+            expense += current.r_amount;
         }
 
-        current_node = current_node->next;
+        printRecordInConsole(&current);
     }
 
+    free(ids);
+
+    flushRecordsInConsole();
+    puts("");
+    printCalculationInConsole(no_of_rec, income, expense);
+    printRecordFooterInConsole();
+
     return 0;
 }
 
 
 /*
- * Function to check if the given file name is valid or not
- * Note: FileName should be without extention
+ * Function to group the records by entity, month, year or type
+ * (hash aggregation), and view the totals of every group
+ * FORMAT: group by <entity/month/year/type> [filter expression]
  *
- * return 1 - valid fileName 
+ * only the records matching the filter expression are grouped (if given)
  */
-static int isValidFileName(const char *fileName) 
+int groupRecord(InexDataPtr inex, char **token)
 {
-    int index; 
-    char ch;
+    FilterProgram program;
+    GroupTable table;
+    StoreTotals totals;
+    const GroupBucket *group;
+    char name[ENTITY_LEN];
+    int by, index, width;
 
-    if (fileName == NULL) 
-        return 0;
+    if (inex == NULL || token == NULL) {
+        logError(ERROR_FUNC_ARG);
+        return -2;
+    }
 
-    for (index = 0; index < FILE_NAME_LEN; index++) {
-        ch = fileName[index];
+    if (token[1] == NULL || strcmp(token[1], "by") != 0 || token[2] == NULL)
+        return 1;
 
-        if (ch == '\0')
+    for (by = GROUP_ENTITY; by <= GROUP_TYPE; by++) {
+        if (strcmp(token[2], group_field[by]) == 0)
             break;
+    }
 
-        /* only 25 characters are allowed */
-        if (index >= (FILE_NAME_LEN - 7))
-            return 0;
+    if (by > GROUP_TYPE)
+        return 1;
 
-        /*
-         * (0 - 9) is allowed
-         * (a - z) is allowed
-         * (A - Z) is allowed
-         * underscore (_) and hyphen (-) is allowed
-         */
-        if ((ch >= '0' && ch <= '9') 
-                || (ch >= 'a' && ch <= 'z') 
-                || (ch >= 'A' && ch <= 'Z') 
-                || (ch == '-') 
-                || (ch == '_')) {
-            continue;
-        }
+    if (token[3] == NULL) {
+        /* every record has a date key within this range */
+        rangeFilter(&program, FILTER_DATE, 0, INT_MAX);
+    } else if (compileFilter(&program, &token[3]) != 0) {
+        return 1;
+    }
 
-        return 0;
+    initGroupTable(&table, by);
+
+    if (scanRecords(inex, &program, groupSelectedRecords, &table, &totals) != 0
+            || table.lost) {
+        freeGroupTable(&table);
+        return -1;
     }
 
-    return 1;
-}
+    sortGroupTable(&table);
 
+    /* entity is left aligned, other fields are right aligned */
+    width = (by == GROUP_ENTITY) ? -(ENTITY_LEN - 1) : 7;
 
-/*
- * To check if a file with given fileName exist or not
- *
- * return 1 - definitely exist (100%)
- */
-static int fileExist(const char *fileName) 
-{
-    FILE *fp;
+    puts(group_header);
+    printGroupSeperator(width);
+    printf(" %*s%s\n", width, group_column[by], group_column_text);
+    printGroupSeperator(width);
 
-    if (fileName == NULL) 
-        return 0;
+    for (index = 0; index < table.count; index++) {
+        group = &table.slot[index];
 
-    fp = fopen(fileName, "rb");
+        switch (by) {
+            case GROUP_ENTITY:
+                snprintf(name, sizeof(name), "%s", group->name);
+                break;
 
-    if (fp == NULL)
-        return 0;
+            case GROUP_MONTH:
+                snprintf(name, sizeof(name), "%04d-%02d", 
+                    PERIOD_YEAR(group->key), PERIOD_MONTH(group->key));
+                break;
 
-    fclose(fp);
+            case GROUP_YEAR:
+                snprintf(name, sizeof(name), "%04d", group->key);
+                break;
 
-    return 1;
-} 
+            default:
+                snprintf(name, sizeof(name), "%s", 
+                    (group->key & 1) ? "income" : "expense");
+                break;
+        }
+
+        printTotalsRow(name, width, group->count, group->income, group->expense);
+    }
+
+    printGroupSeperator(width);
+    puts("");
+    printCalculationInConsole(totals.count, totals.income, totals.expense);
+    puts("");
+
+    freeGroupTable(&table);
+
+    return 0;
+}
 
 
 /*
- * Function to update the meta data of the inex data based on delete or edit
+ * Function to view the k records of largest amount (from the largest)
+ * FORMAT: top <k> [in/ex] [<min_date> <max_date>]
  *
- * In case of delete, only Node is present
- * In case of edit, a Node (with existing data) and replacing record values
+ * records are streamed through a heap of k records, instead of sorting
  */
-static int metaUpdate(InexDataPtr inex, ListNodePtr node, Record *rec)
+int topRecord(InexDataPtr inex, char **token)
 {
-    if (inex == NULL || node == NULL) 
-        return -2;
+    static char date_token[] = "date";
+    char *expression[5];
+    FilterProgram program;
+    TopHeap heap;
+    Record current;
+    StorePos pos;
+    StoreTotals totals;
+    int k, index, count = 0;
+    char ch;
 
-    /* 
-     * Subtract the existing amount (for both delete and edit)
-     */
-    if (node->rec.r_info & 1) {
-        inex->meta.md_total_income -= node->rec.r_amount;
-    } else {
-        inex->meta.md_total_expense -= node->rec.r_amount;
+    /* for calculation based on the top records */
+    long income     = 0;
+    long expense    = 0;
+
+    if (inex == NULL || token == NULL) {
+        logError(ERROR_FUNC_ARG);
+        return -2;
     }
 
-    /* 
-     * if rec is NULL, then it means only delete. 
-     * so, decrease no of record count 
-     */
-    if (rec == NULL)
-        inex->meta.md_record_count--;
+    if (token[1] == NULL || sscanf(token[1], "%d%c", &k, &ch) != 1 || k <= 0)
+        return 1;
 
-    /* 
-     * if rec is NOT NULL, then it means edit 
-     */
-    if (rec != NULL) {
-        if (rec->r_amount >= 0) {
-            /* 
-             * if Amount field going to be edited, 
-             * subtract existing value from income or expense (already did)
-             * add the new value into income or expense (below)
-             */
-            if (node->rec.r_info & 1) {
-                inex->meta.md_total_income += rec->r_amount;
-            } else {
-                inex->meta.md_total_expense += rec->r_amount;
-            }
+    /* optional type and date range, as a filter expression */
+    index = 2;
+
+    if (token[index] != NULL && (strcmp(token[index], "in") == 0 
+            || strcmp(token[index], "ex") == 0))
+        expression[count++] = token[index++];
+
+    if (token[index] != NULL) {
+        if (token[index + 1] == NULL || token[index + 2] != NULL)
+            return 1;
+
+        expression[count++] = date_token;
+        expression[count++] = token[index];
+        expression[count++] = token[index + 1];
+    }
+
+    expression[count] = NULL;
+
+    if (count == 0) {
+        /* every record has a date key within this range */
+        rangeFilter(&program, FILTER_DATE, 0, INT_MAX);
+    } else if (compileFilter(&program, expression) != 0) {
+        return 1;
+    }
+
+    /* no more than all the records can be shown */
+    if (k > inex->store.count)
+        k = (inex->store.count > 0) ? inex->store.count : 1;
+
+    if (initTopHeap(&heap, k) != 0)
+        return -1;
+
+    if (scanRecords(inex, &program, pushSelectedRecords, &heap, &totals) != 0) {
+        freeTopHeap(&heap);
+        return -1;
+    }
+
+    sortTopHeap(&heap);
+
+    printRecordHeaderInConsole();
+
+    for (index = 0; index < heap.count; index++) {
+        pos.leaf    = (StoreLeaf *) heap.entry[index].leaf;
+        pos.index   = heap.entry[index].index;
+
+        getStoreRecord(&pos, &current);
+        printRecordInConsole(&current);
+
+        if (current.r_info & 1) {
+            income += current.r_amount;
         } else {
-            /* 
-             * if No changes in Amount field during edit, 
-             * restore the subtracted value in the first step (because no changes)
-             */
-            if (node->rec.r_info & 1) {
-                inex->meta.md_total_income += node->rec.r_amount;
-            } else {
-                inex->meta.md_total_expense += node->rec.r_amount;
-            }
+            expense += current.r_amount;
         }
     }
 
+    flushRecordsInConsole();
+    puts("");
+    printCalculationInConsole(heap.count, income, expense);
+    printRecordFooterInConsole();
+
+    freeTopHeap(&heap);
+
     return 0;
 }
 
 
 /*
- * Function to insert node into correct position of the list
+ * Generic Filter function to call the specific filter function 
+ * based on the fieldName mentioned by the user
  */
-static int insertListNode(InexDataPtr inex, ListNodePtr node)
+int filterRecord(InexDataPtr inex, char **token)
 {
-    ListNodePtr current;
+    struct rowLimit limit;
+    int index = 0;
 
-    if (inex == NULL || node == NULL)
+    if (inex == NULL || token == NULL) {
+        logError(ERROR_FUNC_ARG);
         return -2;
-
-    current     = inex->headNode;
-    node->next  = NULL;
-
-    /* if no exiting records */
-    if (inex->headNode == NULL) {
-        inex->headNode = node;
-        return 0;
     }
 
-    /* if the new record needs to be in top */
-    if (compareDate(node->rec.r_date, current->rec.r_date) >= 0) {
-        node->next      = inex->headNode;
-        inex->headNode  = node;
-        return 0;
+    /* First token should be 'filter' */
+    if (token[0] == NULL || strcmp(token[0], "filter") != 0) {
+        logError(ERROR_WENT_WRONG);
+        return -1;
     }
 
-    while (current != NULL) {
-        /* when tail is reached add the new record in the end */
-        if (current->next == NULL) {
-            current->next = node;
-            return 0;
-        }
+    if (token[1] == NULL) 
+        return -1;
 
-        /* if new record date is >= current->next record date */
-        if (compareDate(node->rec.r_date, current->next->rec.r_date) >= 0) {
-            node->next      = current->next;
-            current->next   = node;
-            return 0;
+    /* 'limit <n>' and 'offset <m>' at the end are not part of the filter */
+    if (cutRowLimit(token, &limit) != 0 || token[1] == NULL)
+        return 1;
+
+    /* 
+     * combination of terms (or in/ex) is filtered as an expression,
+     * single date or amount range through the filter lookup
+     */
+    if (token[2] != NULL && token[3] != NULL && token[4] != NULL 
+            && strcmp(token[4], "--totals") != 0)
+        return filterByExpression(inex, token, &limit);
+
+    /* loop through filter lookup */
+    while (filter_lookup[index].fieldName != NULL) {
+
+        /* 
+         * if the 2nd token matches with the filter lookup fieldName 
+         * call the corresponding filter function based on fiedlName
+         */
+        if (strcmp(filter_lookup[index].fieldName, token[1]) == 0) {
+            return filter_lookup[index].filter(inex, token, &limit);
         }
 
-        current = current->next;
+        index++;
     }
 
-    return 1;
-} 
+    return filterByExpression(inex, token, &limit);
+}
 
 
 /*
- * Function to update the record of a node 
+ * Function to export the records into a new file, 
+ * token: export <csv|ndjson> <path> [filter expression]
+ * records (matching the filter) are written from the oldest
  *
- * Returns no of fields updated
- * Return < 0, indicates error 
+ * Return = 0, indicates success
+ * Return > 0, indicates invalid arguments (or file already exists)
+ * Return < 0, indicates error
  */
-static int updateListNode(ListNodePtr node, Record *rec)
+int exportRecord(InexDataPtr inex, char **token)
 {
-    int no_of_field_updated = 0;
+    FilterProgram program;
+    ExportWriter writer;
+    StoreLeaf *leaf;
+    uint64_t mask[MASK_WORDS(LEAF_CAPACITY)];
+    int format, returnCode = 0;
 
-    if (node == NULL || rec == NULL)
+    if (inex == NULL || token == NULL) {
+        logError(ERROR_FUNC_ARG);
         return -2;
+    }
 
-    /* 
-     * update each field seperately 
-     * based on the validity of each field 
-     */
+    format = exportFormat(token[1]);
+    if (format == 0 || token[2] == NULL)
+        return 1;
 
-    if (isValidAmount(&rec->r_amount)) {
-        node->rec.r_amount = rec->r_amount;
-        no_of_field_updated++;
-    }
+    /* without filter, all the records are exported */
+    if (token[3] != NULL && compileFilter(&program, &token[3]) != 0)
+        return 1;
 
-    if (isValidDate(&rec->r_date)) {
-        node->rec.r_date = rec->r_date;
-        no_of_field_updated++;
+    returnCode = openExportWriter(&writer, token[2], format);
+    if (returnCode > 0) {
+        puts("\tMESSAGE: File already exists!");
+        return 2;
     }
 
-    /* update only when the incoming string is valid and non-empty */
-    if (isValidRecordEntity(rec) && strcmp(rec->r_entity, "") != 0) {
-        strncpy(node->rec.r_entity, rec->r_entity, ENTITY_LEN);
-        no_of_field_updated++;
+    if (returnCode < 0)
+        return -1;
+
+    for (leaf = inex->store.head; leaf != NULL && returnCode == 0; 
+            leaf = leaf->next) {
+        if (leaf->count == 0 || token[3] == NULL) {
+            returnCode = exportLeafRecords(&writer, leaf, NULL);
+            continue;
+        }
+
+        /* only the leaves of the date range of the filter */
+        if (leaf->date_key[leaf->count - 1] < program.min_key)
+            continue;
+
+        if (leaf->date_key[0] > program.max_key)
+            break;
+
+        selectFilter(&program, leaf, mask);
+        returnCode = exportLeafRecords(&writer, leaf, mask);
     }
 
-    /* update only when the incoming string is valid and non-empty */
-    if (isValidRecordComment(rec) && strcmp(rec->r_comment, "") != 0) {
-        strncpy(node->rec.r_comment, rec->r_comment, COMMENT_LEN);
-        no_of_field_updated++;
+    if (closeExportWriter(&writer) != 0 || returnCode != 0) {
+        puts("\tMESSAGE: Export is incomplete!");
+        return -1;
     }
 
-    return no_of_field_updated;
-} 
+    printf("\tMESSAGE: %d records exported!\n", writer.count);
+
+    return 0;
+}
 
 
 /*
- * Function to filter records based on Date field
+ * Function to add the records of a csv file (columns same as the export)
+ * records are read in large chunks and validated, then sorted by date
+ * and merged into the store in one pass (all the records or none)
+ *
+ * Return = 0, indicates success
+ * Return > 0, indicates file or record is not valid (nothing is added)
+ * Return < 0, indicates error
  */
-static int filterByDate(InexDataPtr inex, char **token)
+int importRecord(InexDataPtr inex, const char *path)
 {
-    ListNodePtr current;
-    Date upper_date, lower_date;
-    Date *upper, *lower;
-
-    /* for calculation based on the filtered output */
-    int no_of_rec   = 0;
-    long income     = 0;
-    long expense    = 0;
+    ImportReader reader;
+    Record *batch = NULL;
+    int count = 0;
+    int returnCode;
 
-    if (inex == NULL || token == NULL) {
+    if (inex == NULL || path == NULL) {
         logError(ERROR_FUNC_ARG);
         return -2;
     }
 
-    if (token[2] == NULL || token[3] == NULL) 
-        return -1;
-    
-    /* 
-     * The upper limit should be a valid date or dot (.) 
-     * if valid date -> parse the value into date format, store address in upper
-     * else if dot (.) -> make upper as NULL
-     * otherwise return
-     */
-    if (parseStringToDate(token[2], &upper_date) != 0) {
-        if (strcmp(token[2],".") != 0)
-            return 1;
-        
-        upper = NULL;
-    } else {
-        upper = &upper_date;
-    }
-        
-    /* 
-     * The lower limit should be a valid date or dot (.) 
-     * if valid date -> parse the value into date format, store address in lower
-     * else if dot (.) -> make lower as NULL
-     * otherwise return
-     */
-    if (parseStringToDate(token[3], &lower_date) != 0) {
-        if (strcmp(token[3],".") != 0)
-            return 1;
-        
-        lower = NULL;
-    } else {
-        lower = &lower_date;
+    returnCode = openImportReader(&reader, path);
+    if (returnCode > 0) {
+        puts("\tMESSAGE: File doesn't exist!");
+        return 2;
     }
 
-    current = inex->headNode;
-    printRecordHeaderInConsole();
+    if (returnCode < 0)
+        return -1;
 
-    /* loop through every records */
-    while (current != NULL) {
-        /* if the current record falls in filter range, proceed further */
-        if (isRecordBetweenDateRange(&current->rec, upper, lower)) {
-            no_of_rec++;
+    returnCode = readImportBatch(inex, &reader, &batch, &count);
 
-            if (current->rec.r_info & 1) {
-                income += current->rec.r_amount;
-            } else {
-                expense += current->rec.r_amount;
-            }
+    if (returnCode == 2)
+        printf("\tMESSAGE: Invalid record at line %d!\n", reader.line);
 
-            printRecordInConsole(&current->rec);
-        }
+    if (returnCode == 3)
+        puts("\tMESSAGE: Application limit reached!");
 
-        current = current->next;
-    }
+    closeImportReader(&reader);
 
-    puts("");
-    printCalculationInConsole(no_of_rec, income, expense);
-    printRecordFooterInConsole();
+    if (returnCode == 0 && mergeImportBatch(inex, batch, count) != 0)
+        returnCode = -1;
+
+    free(batch);
+
+    if (returnCode != 0)
+        return (returnCode > 0) ? returnCode : -1;
+
+    printf("\tMESSAGE: %d records imported!\n", count);
 
     return 0;
 }
 
 
+void showFileName(InexDataPtr inex) 
+{
+    if (inex == NULL)
+        return;
+
+    printf("%s",inex->meta.md_file_name);
+}
+
+
 /*
- * Function to filter records based on Amount field
+ * Function to read inex data from file 
  */
-static int filterByAmount(InexDataPtr inex, char **token)
+static int readInexDataFromFile(InexDataPtr inex, FILE *fp) 
 {
-    ListNodePtr current;
-    long upper_amount, lower_amount;
-    long *upper, *lower;
-
-    /* for calculation based on the filtered output */
-    int no_of_rec   = 0;
-    long income     = 0;
-    long expense    = 0;
+    int returnCode;
 
-    if (inex == NULL || token == NULL) {
+    if (inex == NULL || fp == NULL) {
         logError(ERROR_FUNC_ARG);
         return -2;
     }
 
-    if (token[2] == NULL || token[3] == NULL)
+    if (fread(&inex->meta, sizeof(inex->meta), 1, fp) != 1) {
+        logError(ERROR_FILE_READ);
         return -1;
-
-    /* 
-     * The upper limit should be a valid amount or dot (.) 
-     * if valid amount -> parse the value as Amount format, store address in upper
-     * else if dot (.) -> make upper as NULL
-     * otherwise return
-     */
-    if (parseStringToAmount(token[2], &upper_amount) != 0) {
-        if (strcmp(token[2],".") != 0)
-            return 1;
-        
-        upper = NULL;
-    } else {
-        upper = &upper_amount;
-    }
-        
-    /* 
-     * The lower limit should be a valid amount or dot (.) 
-     * if valid amount -> parse the value as Amount format, store address in lower
-     * else if dot (.) -> make lower as NULL
-     * otherwise return
-     */
-    if (parseStringToAmount(token[3], &lower_amount) != 0) {
-        if (strcmp(token[3],".") != 0)
-            return 1;
-        
-        lower = NULL;
-    } else {
-        lower = &lower_amount;
     }
 
-    current = inex->headNode;
-    printRecordHeaderInConsole();
+    if (strncmp(inex->meta.md_header, legacy_header_name, HEADER_LEN) == 0)
+        return readLegacyRecords(inex, fp);
 
-    /* loop through every records */
-    while (current != NULL) {
-        /* if the current record falls in filter range, proceed further */
-        if (isRecordBetweenAmountRange(&current->rec, upper, lower)) {
-            no_of_rec++;
+    if (strncmp(inex->meta.md_header, v2_header_name, HEADER_LEN) == 0)
+        return readV2Records(inex, fp);
 
-            if (current->rec.r_info & 1) {
-                income += current->rec.r_amount;
-            } else {
-                expense += current->rec.r_amount;
-            }
+    if ((strncmp(inex->meta.md_header, header_name, HEADER_LEN) != 0 
+                && strncmp(inex->meta.md_header, v3_header_name, HEADER_LEN) != 0)
+            || inex->meta.md_record_count < 0) {
+        puts("\tMESSAGE: Not a valid InEx file!");
+        return 1;
+    }
 
-            printRecordInConsole(&current->rec);
-        }
+    if (readRecordStore(&inex->store, fp, inex->meta.md_record_count) != 0)
+        return -1;
 
-        current = current->next;
-    }
+    /* rollups are after the columns, built from the records for old files */
+    returnCode = 1;
 
-    puts("");
-    printCalculationInConsole(no_of_rec, income, expense);
-    printRecordFooterInConsole();
+    if (strncmp(inex->meta.md_header, header_name, HEADER_LEN) == 0)
+        returnCode = readRollup(&inex->rollup, fp);
+
+    if (returnCode < 0)
+        return -1;
+
+    if (returnCode > 0)
+        return buildRollup(inex);
 
     return 0;
-} 
\ No newline at end of file
+}
+
+
+/*
+ * Function to read the records of old InEx file (one record after another)
+ */
+static int readLegacyRecords(InexDataPtr inex, FILE *fp)
+{
+    Record *records;
+    long start, end;
+    int count, returnCode;
+
+    start = ftell(fp);
+
+    if (fseek(fp, 0, SEEK_END) != 0 || (end = ftell(fp)) < start
+            || fseek(fp, start, SEEK_SET) != 0) {
+        logError(ERROR_FILE_READ);
+        return -1;
+    }
+
+    count = (end - start) / sizeof(*records);
+
+    records = malloc((count > 0 ? count : 1) * sizeof(*records));
+    if (records == NULL) {
+        logError(ERROR_MEMORY_ALLOC);
+        return -1;
+    }
+
+    if (fread(records, sizeof(*records), count, fp) != (size_t) count) {
+        logError(ERROR_FILE_READ);
+        free(records);
+        return -1;
+    }
+
+    returnCode = loadLegacyRecords(inex, records, count);
+    free(records);
+
+    return returnCode;
+}
+
+
+/*
+ * Function to read the columns of v2 InEx file (date column as Date)
+ */
+static int readV2Records(InexDataPtr inex, FILE *fp)
+{
+    char *columns;
+    long start, end;
+    size_t length;
+    int returnCode;
+
+    start = ftell(fp);
+
+    if (fseek(fp, 0, SEEK_END) != 0 || (end = ftell(fp)) < start
+            || fseek(fp, start, SEEK_SET) != 0) {
+        logError(ERROR_FILE_READ);
+        return -1;
+    }
+
+    length = (size_t) (end - start);
+
+    columns = malloc(length > 0 ? length : 1);
+    if (columns == NULL) {
+        logError(ERROR_MEMORY_ALLOC);
+        return -1;
+    }
+
+    if (fread(columns, 1, length, fp) != length) {
+        logError(ERROR_FILE_READ);
+        free(columns);
+        return -1;
+    }
+
+    returnCode = loadV2Records(inex, columns, length);
+    free(columns);
+
+    return returnCode;
+}
+
+
+/*
+ * Function to write inex data into file 
+ */
+static int writeInexDataIntoFile(InexDataPtr inex, FILE *fp) 
+{
+    if (inex == NULL || fp == NULL) {
+        logError(ERROR_FUNC_ARG);
+        return -2;
+    }
+
+    inex->meta.md_record_count = inex->store.count;
+
+    if (fwrite(&inex->meta, sizeof(inex->meta), 1, fp) != 1) {
+        logError(ERROR_FILE_WRITE);
+        return -1;
+    }
+
+    if (writeRecordStore(&inex->store, fp) != 0)
+        return -1;
+
+    if (inex->rollup.lost && buildRollup(inex) != 0)
+        return -1;
+
+    return writeRollup(&inex->rollup, fp);
+}
+
+
+/*
+ * Function to write the complete InEx Data into file, and remove the journal
+ *
+ * Data is written into a temporary file and renamed over the existing one,
+ * the opened (mapped) file is never truncated while it is still in use
+ */
+static int compactInexData(InexDataPtr inex, const char *completeFileName,
+        const char *journalFileName)
+{
+    FILE *fp;
+    char tempFileName[FILE_NAME_LEN + 8];
+    int returnCode;
+
+    snprintf(tempFileName, sizeof(tempFileName), "%s.tmp", completeFileName);
+
+    fp = fopen(tempFileName, "wb");
+    if (fp == NULL) {
+        logError(ERROR_FILE_OPEN);
+        return -3;
+    }
+
+    returnCode = writeInexDataIntoFile(inex, fp);
+    if (returnCode != 0) {
+        fclose(fp);
+        remove(tempFileName);
+        return returnCode;
+    }
+
+    /* file should be on disk, before the journal is removed */
+    if (fflush(fp) != 0 || fsync(fileno(fp)) != 0 || fclose(fp) != 0 
+            || rename(tempFileName, completeFileName) != 0) {
+        logError(ERROR_FILE_WRITE);
+        remove(tempFileName);
+        return -1;
+    }
+
+    /* 
+     * if journal is not removed, it is applied again on open
+     * which gives the same records (every entry has the complete record)
+     */
+    inex->journal.count     = 0;
+    inex->journal.lost      = 0;
+    inex->full_save         = 0;
+    inex->backup_generation = inex->generation;
+
+    return removeJournal(&inex->journal, journalFileName);
+}
+
+
+/*
+ * Function to apply a journal entry into the InEx Data (while opening)
+ * entries already present in the file are skipped or give the same result
+ */
+static int replayJournalEntry(void *context, int operation, const Record *rec)
+{
+    InexDataPtr inex = context;
+    Record current;
+    StorePos pos;
+    int found;
+
+    found = findStoreRecord(&inex->store, rec->r_id, &pos);
+    if (found < 0)
+        return -1;
+
+    switch (operation) {
+        case JOURNAL_ADD:
+            if (found == 0)
+                return 0;
+
+            if (insertStoreRecord(&inex->store, rec) != 0)
+                return -1;
+
+            metaApplyRecord(inex, rec, 1);
+
+            if (rec->r_id >= inex->meta.md_counter)
+                inex->meta.md_counter = rec->r_id + 1;
+            break;
+
+        case JOURNAL_EDIT:
+        case JOURNAL_EDIT_DATE:
+            if (found != 0)
+                return 0;
+
+            getStoreRecord(&pos, &current);
+
+            /* same as edit, date edit changes the position of the record */
+            if (operation == JOURNAL_EDIT_DATE) {
+                if (removeStoreRecord(&inex->store, &pos) != 0
+                        || insertStoreRecord(&inex->store, rec) != 0)
+                    return -1;
+            } else {
+                if (setStoreRecord(&inex->store, &pos, rec) != 0)
+                    return -1;
+            }
+
+            metaApplyRecord(inex, &current, -1);
+            metaApplyRecord(inex, rec, 1);
+            break;
+
+        case JOURNAL_DELETE:
+            if (found != 0)
+                return 0;
+
+            getStoreRecord(&pos, &current);
+
+            if (removeStoreRecord(&inex->store, &pos) != 0)
+                return -1;
+
+            metaApplyRecord(inex, &current, -1);
+            break;
+
+        default:
+            return 1;
+    }
+
+    return 0;
+}
+
+
+/*
+ * Function to map the InEx file into memory (private mapping)
+ * meta data is copied, but the columns of the store are 
+ * pointing directly into the mapping
+ *
+ * Return = 0, indicates success
+ * Return > 0, indicates mapping not possible (caller can read the file)
+ * Return < 0, indicates error
+ */
+static int mapInexDataFromFile(InexDataPtr inex, const char *completeFileName)
+{
+    struct stat st;
+    void *base;
+    size_t length, offset;
+    int fd, returnCode;
+
+    if (inex == NULL || completeFileName == NULL) {
+        logError(ERROR_FUNC_ARG);
+        return -2;
+    }
+
+    fd = open(completeFileName, O_RDONLY);
+    if (fd < 0)
+        return 1;
+
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t) sizeof(inex->meta)) {
+        close(fd);
+        return 2;
+    }
+
+    length = (size_t) st.st_size;
+
+    /* 
+     * private and writable mapping, so that the records can be modified 
+     * in memory (copy on write) without affecting the file 
+     */
+    base = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (base == MAP_FAILED)
+        return 3;
+
+    /* columns are mostly scanned from one end to another */
+    madvise(base, length, MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+    madvise(base, length, MADV_HUGEPAGE);
+#endif
+
+    memcpy(&inex->meta, base, sizeof(inex->meta));
+
+    /* old files are loaded into memory, and mapping is not needed anymore */
+    if (strncmp(inex->meta.md_header, legacy_header_name, HEADER_LEN) == 0) {
+        returnCode = loadLegacyRecords(inex, (Record *) ((char *) base 
+            + sizeof(inex->meta)), (length - sizeof(inex->meta)) / sizeof(Record));
+        munmap(base, length);
+        return returnCode;
+    }
+
+    if (strncmp(inex->meta.md_header, v2_header_name, HEADER_LEN) == 0) {
+        returnCode = loadV2Records(inex, (char *) base + sizeof(inex->meta),
+            length - sizeof(inex->meta));
+        munmap(base, length);
+        return returnCode;
+    }
+
+    if ((strncmp(inex->meta.md_header, header_name, HEADER_LEN) != 0 
+                && strncmp(inex->meta.md_header, v3_header_name, HEADER_LEN) != 0)
+            || inex->meta.md_record_count < 0) {
+        munmap(base, length);
+        puts("\tMESSAGE: Not a valid InEx file!");
+        return -1;
+    }
+
+    /* store takes the ownership of the mapping */
+    if (attachRecordStore(&inex->store, base, length, sizeof(inex->meta), 
+            inex->meta.md_record_count) != 0) {
+        munmap(base, length);
+        return -1;
+    }
+
+    /* rollups are after the columns, built from the records for old files */
+    offset      = sizeof(inex->meta) + recordStoreFileSize(inex->meta.md_record_count);
+    returnCode  = 1;
+
+    if (strncmp(inex->meta.md_header, header_name, HEADER_LEN) == 0)
+        returnCode = loadRollup(&inex->rollup, (char *) base + offset, length - offset);
+
+    if (returnCode < 0)
+        return -1;
+
+    if (returnCode > 0)
+        return buildRollup(inex);
+
+    return 0;
+}
+
+
+/*
+ * Function to load the records of old InEx file into the store
+ * records are stored from the latest, so it is inserted from the last
+ * (every insert goes to the tail of the store)
+ */
+static int loadLegacyRecords(InexDataPtr inex, const Record *records, int count)
+{
+    int index;
+
+    for (index = count - 1; index >= 0; index--) {
+        if (insertStoreRecord(&inex->store, &records[index]) != 0)
+            return -1;
+    }
+
+    /* will be saved in the current format (complete file) */
+    strncpy(inex->meta.md_header, header_name, HEADER_LEN);
+    inex->meta.md_record_count = count;
+
+    return buildRollup(inex);
+}
+
+
+/*
+ * Function to load the columns of v2 InEx file into the store
+ * date of every record is converted into the packed date key
+ */
+static int loadV2Records(InexDataPtr inex, const void *columns, size_t length)
+{
+    if (inex->meta.md_record_count < 0) {
+        puts("\tMESSAGE: Not a valid InEx file!");
+        return 1;
+    }
+
+    if (loadRecordStoreV2(&inex->store, columns, length, 
+            inex->meta.md_record_count) != 0)
+        return -1;
+
+    return buildRollup(inex);
+}
+
+
+/*
+ * Function to build the rollups from all the records of the store
+ * used for the files saved without rollups, or when the rollup is lost
+ * file is saved in the current format (complete file) on next save
+ */
+static int buildRollup(InexDataPtr inex)
+{
+    const StoreLeaf *leaf;
+    int index;
+
+    freeRollup(&inex->rollup);
+
+    for (leaf = inex->store.head; leaf != NULL; leaf = leaf->next) {
+        for (index = 0; index < leaf->count; index++) {
+            if (applyRollup(&inex->rollup, leaf->date_key[index], 
+                    leaf->info[index], leaf->amount[index], 1) != 0)
+                return -1;
+        }
+    }
+
+    strncpy(inex->meta.md_header, header_name, HEADER_LEN);
+    inex->full_save = 1;
+
+    return 0;
+}
+
+
+/*
+ * To print the totals of a period (year or month) as a row in console
+ */
+static void printRollupBucket(const RollupBucket *bucket, int monthly)
+{
+    char period[24];
+
+    if (monthly) {
+        snprintf(period, sizeof(period), "%04d-%02d", 
+            PERIOD_YEAR(bucket->period), PERIOD_MONTH(bucket->period));
+    } else {
+        snprintf(period, sizeof(period), "%04d", bucket->period);
+    }
+
+    printTotalsRow(period, 7, bucket->count, bucket->income, bucket->expense);
+}
+
+
+static void printGroupSeperator(int width)
+{
+    int index;
+
+    for (index = 0; index < abs(width) + 2; index++)
+        putchar('-');
+
+    puts(group_seperator_text);
+}
+
+
+/*
+ * Function to print a row of totals (summary and group)
+ * name is right aligned within width (left aligned, if width is negative)
+ */
+static void printTotalsRow(const char *name, int width, int count, long income,
+        long expense)
+{
+    char income_text[AMOUNT_TEXT_LEN + 1];
+    char expense_text[AMOUNT_TEXT_LEN + 1];
+    char balance_text[AMOUNT_TEXT_LEN + 1];
+
+    income_text[formatAmount(income_text, income)]                = '\0';
+    expense_text[formatAmount(expense_text, expense)]             = '\0';
+    balance_text[formatAmount(balance_text, income - expense)]    = '\0';
+
+    printf(" %*s | %7d | %15s | %15s | %15s\n"
+        , width, name, count, income_text, expense_text, balance_text);
+}
+
+
+/*
+ * Function to check if the given file name is valid or not
+ * Note: FileName should be without extention
+ *
+ * return 1 - valid fileName 
+ */
+static int isValidFileName(const char *fileName) 
+{
+    int index; 
+    char ch;
+
+    if (fileName == NULL) 
+        return 0;
+
+    for (index = 0; index < FILE_NAME_LEN; index++) {
+        ch = fileName[index];
+
+        if (ch == '\0')
+            break;
+
+        /* only 25 characters are allowed */
+        if (index >= (FILE_NAME_LEN - 7))
+            return 0;
+
+        /*
+         * (0 - 9) is allowed
+         * (a - z) is allowed
+         * (A - Z) is allowed
+         * underscore (_) and hyphen (-) is allowed
+         */
+        if ((ch >= '0' && ch <= '9') 
+                || (ch >= 'a' && ch <= 'z') 
+                || (ch >= 'A' && ch <= 'Z') 
+                || (ch == '-') 
+                || (ch == '_')) {
+            continue;
+        }
+
+        return 0;
+    }
+
+    return 1;
+}
+
+
+/*
+ * To check if a file with given fileName exist or not
+ *
+ * return 1 - definitely exist (100%)
+ */
+static int fileExist(const char *fileName) 
+{
+    FILE *fp;
+
+    if (fileName == NULL) 
+        return 0;
+
+    fp = fopen(fileName, "rb");
+
+    if (fp == NULL)
+        return 0;
+
+    fclose(fp);
+
+    return 1;
+} 
+
+
+/*
+ * Function to update the meta data of the inex data based on delete or edit
+ *
+ * In case of delete, only old record is present
+ * In case of edit, old record (with existing data) and replacing record values
+ */
+static int metaUpdate(InexDataPtr inex, const Record *old, const Record *rec)
+{
+    if (inex == NULL || old == NULL) 
+        return -2;
+
+    /* 
+     * Subtract the existing amount (for both delete and edit)
+     */
+    if (old->r_info & 1) {
+        inex->meta.md_total_income -= old->r_amount;
+    } else {
+        inex->meta.md_total_expense -= old->r_amount;
+    }
+
+    /* 
+     * if rec is NULL, then it means only delete. 
+     * so, decrease no of record count 
+     */
+    if (rec == NULL)
+        inex->meta.md_record_count--;
+
+    /* 
+     * record is removed from the rollup of its period, and
+     * for edit, added again with the edited date and amount (if given)
+     */
+    applyRollup(&inex->rollup, DATE_KEY(old->r_date), old->r_info, 
+        old->r_amount, -1);
+
+    if (rec != NULL) {
+        applyRollup(&inex->rollup, 
+            DATE_KEY(isValidDate(&rec->r_date) ? rec->r_date : old->r_date),
+            old->r_info, (rec->r_amount >= 0) ? rec->r_amount : old->r_amount, 1);
+    }
+
+    /* 
+     * if rec is NOT NULL, then it means edit 
+     */
+    if (rec != NULL) {
+        if (rec->r_amount >= 0) {
+            /* 
+             * if Amount field going to be edited, 
+             * subtract existing value from income or expense (already did)
+             * add the new value into income or expense (below)
+             */
+            if (old->r_info & 1) {
+                inex->meta.md_total_income += rec->r_amount;
+            } else {
+                inex->meta.md_total_expense += rec->r_amount;
+            }
+        } else {
+            /* 
+             * if No changes in Amount field during edit, 
+             * restore the subtracted value in the first step (because no changes)
+             */
+            if (old->r_info & 1) {
+                inex->meta.md_total_income += old->r_amount;
+            } else {
+                inex->meta.md_total_expense += old->r_amount;
+            }
+        }
+    }
+
+    return 0;
+}
+
+
+/*
+ * Function to add (sign = 1) or subtract (sign = -1) the record in meta data
+ */
+static void metaApplyRecord(InexDataPtr inex, const Record *rec, int sign)
+{
+    inex->meta.md_record_count += sign;
+
+    applyRollup(&inex->rollup, DATE_KEY(rec->r_date), rec->r_info, 
+        rec->r_amount, sign);
+
+    if (rec->r_info & 1) {
+        inex->meta.md_total_income += sign * rec->r_amount;
+    } else {
+        inex->meta.md_total_expense += sign * rec->r_amount;
+    }
+}
+
+
+/*
+ * Backup thread, to write the snapshot into temporary file 
+ * and rename it as backup file (.bak)
+ */
+static void *backupThread(void *argument)
+{
+    struct inexBackup *backup = argument;
+    char backupFileName[FILE_NAME_LEN];
+    char tempFileName[FILE_NAME_LEN + 8];
+    FILE *fp;
+    int returnCode = -1;
+
+    strncpy(backupFileName, backup->meta.md_file_name, FILE_NAME_LEN);
+    strncat(backupFileName, ".bak", 5);
+
+    snprintf(tempFileName, sizeof(tempFileName), "%s.tmp", backupFileName);
+
+    fp = fopen(tempFileName, "wb");
+
+    if (fp != NULL) {
+        if (fwrite(&backup->meta, sizeof(backup->meta), 1, fp) == 1
+                && writeStoreSnapshot(&backup->snapshot, fp) == 0
+                && writeRollup(&backup->rollup, fp) == 0
+                && fflush(fp) == 0 && fsync(fileno(fp)) == 0)
+            returnCode = 0;
+
+        if (fclose(fp) != 0)
+            returnCode = -1;
+
+        if (returnCode == 0 && rename(tempFileName, backupFileName) != 0)
+            returnCode = -1;
+
+        if (returnCode != 0)
+            remove(tempFileName);
+    }
+
+    backup->result = returnCode;
+    atomic_store(&backup->done, 1);
+
+    return NULL;
+}
+
+
+/*
+ * Function to finish the backup thread (if any) and release its snapshot
+ * wait = 0, do not wait if the backup is still running
+ *
+ * Return = 0, indicates no backup is running now
+ * Return > 0, indicates backup is still running
+ */
+static int finishBackup(InexDataPtr inex, int wait)
+{
+    struct inexBackup *backup = &inex->backup;
+
+    if (backup->running == 0)
+        return 0;
+
+    if (wait == 0 && atomic_load(&backup->done) == 0)
+        return 1;
+
+    pthread_join(backup->thread, NULL);
+    releaseStoreSnapshot(&inex->store, &backup->snapshot);
+    backup->running = 0;
+
+    /* backup failed, try again on next backup */
+    if (backup->result != 0) {
+        logError(ERROR_FILE_WRITE);
+        inex->backup_generation = -1;
+    } else {
+        backup->written = 1;
+    }
+
+    return 0;
+}
+
+
+/*
+ * Function to update the fields of a record 
+ *
+ * Returns no of fields updated
+ * Return < 0, indicates error 
+ */
+static int updateRecordFields(Record *dest, const Record *rec)
+{
+    int no_of_field_updated = 0;
+
+    if (dest == NULL || rec == NULL)
+        return -2;
+
+    /* 
+     * update each field seperately 
+     * based on the validity of each field 
+     */
+
+    if (isValidAmount(&rec->r_amount)) {
+        dest->r_amount = rec->r_amount;
+        no_of_field_updated++;
+    }
+
+    if (isValidDate(&rec->r_date)) {
+        dest->r_date = rec->r_date;
+        no_of_field_updated++;
+    }
+
+    /* update only when the incoming string is valid and non-empty */
+    if (isValidRecordEntity(rec) && strcmp(rec->r_entity, "") != 0) {
+        strncpy(dest->r_entity, rec->r_entity, ENTITY_LEN);
+        no_of_field_updated++;
+    }
+
+    /* update only when the incoming string is valid and non-empty */
+    if (isValidRecordComment(rec) && strcmp(rec->r_comment, "") != 0) {
+        strncpy(dest->r_comment, rec->r_comment, COMMENT_LEN);
+        no_of_field_updated++;
+    }
+
+    return no_of_field_updated;
+} 
+
+
+/*
+ * Function to filter records based on Date field
+ */
+static int filterByDate(InexDataPtr inex, char **token,
+        const struct rowLimit *limit)
+{
+    FilterProgram program;
+    StoreTotals totals;
+    Date upper_date, lower_date;
+    Date *upper, *lower;
+
+    if (inex == NULL || token == NULL) {
+        logError(ERROR_FUNC_ARG);
+        return -2;
+    }
+
+    if (token[2] == NULL || token[3] == NULL) 
+        return -1;
+    
+    /* 
+     * The upper limit should be a valid date or dot (.) 
+     * if valid date -> parse the value into date format, store address in upper
+     * else if dot (.) -> make upper as NULL
+     * otherwise return
+     */
+    if (parseStringToDate(token[2], &upper_date) != 0) {
+        if (strcmp(token[2],".") != 0)
+            return 1;
+        
+        upper = NULL;
+    } else {
+        upper = &upper_date;
+    }
+        
+    /* 
+     * The lower limit should be a valid date or dot (.) 
+     * if valid date -> parse the value into date format, store address in lower
+     * else if dot (.) -> make lower as NULL
+     * otherwise return
+     */
+    if (parseStringToDate(token[3], &lower_date) != 0) {
+        if (strcmp(token[3],".") != 0)
+            return 1;
+        
+        lower = NULL;
+    } else {
+        lower = &lower_date;
+    }
+
+    /* both the limits cannot be ignored with dot (.), in both the modes */
+    memset(&totals, 0, sizeof(totals));
+
+    /* only the totals of the range, taken from the totals kept in store */
+    if (token[4] != NULL && strcmp(token[4], "--totals") == 0) {
+        if ((upper != NULL || lower != NULL) && rangeStoreTotals(&inex->store, 
+                (upper != NULL) ? DATE_KEY(*upper) : 0,
+                (lower != NULL) ? DATE_KEY(*lower) : INT_MAX, &totals) != 0)
+            return -1;
+
+        printCalculationInConsole(totals.count, totals.income, totals.expense);
+        return 0;
+    }
+
+    printRecordHeaderInConsole();
+
+    if (upper != NULL || lower != NULL) {
+        rangeFilter(&program, FILTER_DATE,
+            (upper != NULL) ? DATE_KEY(*upper) : 0,
+            (lower != NULL) ? DATE_KEY(*lower) : INT_MAX);
+
+        if (scanFilterRows(inex, &program, limit, &totals) != 0)
+            return -1;
+    }
+
+    flushRecordsInConsole();
+    puts("");
+    printCalculationInConsole(totals.count, totals.income, totals.expense);
+    printRecordFooterInConsole();
+
+    return 0;
+}
+
+
+/*
+ * Function to filter records based on Amount field
+ */
+static int filterByAmount(InexDataPtr inex, char **token,
+        const struct rowLimit *limit)
+{
+    FilterProgram program;
+    StoreTotals totals;
+    long upper_amount, lower_amount;
+    long *upper, *lower;
+
+    if (inex == NULL || token == NULL) {
+        logError(ERROR_FUNC_ARG);
+        return -2;
+    }
+
+    if (token[2] == NULL || token[3] == NULL)
+        return -1;
+
+    /* 
+     * The upper limit should be a valid amount or dot (.) 
+     * if valid amount -> parse the value as Amount format, store address in upper
+     * else if dot (.) -> make upper as NULL
+     * otherwise return
+     */
+    if (parseStringToAmount(token[2], &upper_amount) != 0) {
+        if (strcmp(token[2],".") != 0)
+            return 1;
+        
+        upper = NULL;
+    } else {
+        upper = &upper_amount;
+    }
+        
+    /* 
+     * The lower limit should be a valid amount or dot (.) 
+     * if valid amount -> parse the value as Amount format, store address in lower
+     * else if dot (.) -> make lower as NULL
+     * otherwise return
+     */
+    if (parseStringToAmount(token[3], &lower_amount) != 0) {
+        if (strcmp(token[3],".") != 0)
+            return 1;
+        
+        lower = NULL;
+    } else {
+        lower = &lower_amount;
+    }
+
+    printRecordHeaderInConsole();
+
+    /* both the limits cannot be ignored with dot (.) */
+    memset(&totals, 0, sizeof(totals));
+
+    if (upper != NULL || lower != NULL) {
+        rangeFilter(&program, FILTER_AMOUNT,
+            (upper != NULL) ? *upper : LONG_MIN,
+            (lower != NULL) ? *lower : LONG_MAX);
+
+        if (scanFilterRows(inex, &program, limit, &totals) != 0)
+            return -1;
+    }
+
+    flushRecordsInConsole();
+    puts("");
+    printCalculationInConsole(totals.count, totals.income, totals.expense);
+    printRecordFooterInConsole();
+
+    return 0;
+}
+
+
+/*
+ * Function to filter the records by the expression (tokens after 'filter')
+ * expression is compiled once, and evaluated for every leaf in one pass
+ * only the leaves of the date range covered by the expression are visited
+ */
+static int filterByExpression(InexDataPtr inex, char **token,
+        const struct rowLimit *limit)
+{
+    FilterProgram program;
+    StoreTotals totals;
+
+    if (inex == NULL || token == NULL) {
+        logError(ERROR_FUNC_ARG);
+        return -2;
+    }
+
+    if (compileFilter(&program, &token[1]) != 0)
+        return 1;
+
+    printRecordHeaderInConsole();
+
+    if (scanFilterRows(inex, &program, limit, &totals) != 0)
+        return -1;
+
+    flushRecordsInConsole();
+    puts("");
+    printCalculationInConsole(totals.count, totals.income, totals.expense);
+    printRecordFooterInConsole();
+
+    return 0;
+} 
+
+
+/*
+ * Function to cut the 'limit <n>' and 'offset <m>' clauses from the end
+ * of the tokens (in any order)
+ *
+ * Return = 0, indicates success
+ * Return > 0, indicates invalid clause
+ */
+static int cutRowLimit(char **token, struct rowLimit *limit)
+{
+    int count, value;
+    char ch;
+
+    memset(limit, 0, sizeof(*limit));
+    limit->limit = -1;
+
+    for (count = 0; token[count] != NULL; count++);
+
+    while (count >= 3 && (strcmp(token[count - 2], "limit") == 0
+            || strcmp(token[count - 2], "offset") == 0)) {
+        if (sscanf(token[count - 1], "%d%c", &value, &ch) != 1 || value < 0)
+            return 1;
+
+        if (token[count - 2][0] == 'l') {
+            if (limit->limit >= 0)
+                return 1;
+            limit->limit = value;
+        } else {
+            if (limit->offset > 0)
+                return 1;
+            limit->offset = value;
+        }
+
+        token[count - 2] = NULL;
+        count -= 2;
+    }
+
+    return 0;
+}
+
+
+/*
+ * Function to print the rows of the filter matching the program
+ * totals are of all the matching records, or of the rows shown (with limit)
+ *
+ * with limit (or offset), leaves are selected one by one from the latest,
+ * and the scan ends as soon as the last row is shown
+ */
+static int scanFilterRows(InexDataPtr inex, const FilterProgram *program,
+        const struct rowLimit *limit, StoreTotals *totals)
+{
+    uint64_t mask[MASK_WORDS(LEAF_CAPACITY)];
+    const CachedResult *cached;
+    const StoreLeaf *leaf;
+    struct rowLimit rows;
+    StorePos pos;
+    int index;
+
+    if (limit->limit < 0 && limit->offset == 0)
+        return scanRecords(inex, program, printSelectedRecords, NULL, totals);
+
+    rows = *limit;
+
+    if (rows.limit < 0)
+        rows.limit = INT_MAX;
+
+    /* result of the same program is scanned already */
+    cached = findResultCache(&inex->result_cache, program, inex->generation);
+
+    if (cached != NULL) {
+        for (index = 0; index < cached->count && rows.limit > 0; index++)
+            printLimitedRecords(cached->leaf[index], cached->mask[index], &rows);
+    } else if (seekStoreDate(&inex->store, program->max_key, &pos) == 0) {
+        for (leaf = pos.leaf; leaf != NULL && rows.limit > 0; leaf = leaf->prev) {
+            if (leaf->date_key[leaf->count - 1] < program->min_key)
+                break;
+
+            selectFilter(program, leaf, mask);
+            printLimitedRecords(leaf, mask, &rows);
+        }
+    }
+
+    *totals = rows.totals;
+
+    return 0;
+}
+
+/*
+ * Function to scan the records matching the program, and visit them
+ * (if visit is not NULL) leaf by leaf from the latest record
+ *
+ * leaves of the date range of program are split into tasks, which are
+ * selected and summed in parallel, leaves are visited after that in order
+ * result is cached, the same program is not scanned again till a change
+ *
+ * Return = 0, indicates success
+ * Return < 0, indicates error
+ */
+static int scanRecords(InexDataPtr inex, const FilterProgram *program,
+        LeafVisitor visit, void *context, StoreTotals *totals)
+{
+    const CachedResult *cached;
+    struct leafScan scan;
+    int tasks, index;
+
+    cached = findResultCache(&inex->result_cache, program, inex->generation);
+
+    if (cached != NULL) {
+        *totals = cached->totals;
+
+        if (visit != NULL) {
+            for (index = 0; index < cached->count; index++)
+                visit(cached->leaf[index], cached->mask[index], context);
+        }
+
+        return 0;
+    }
+
+    memset(totals, 0, sizeof(*totals));
+    memset(&scan, 0, sizeof(scan));
+    scan.program = program;
+
+    if (collectScanLeaves(inex, &scan) != 0) {
+        freeLeafScan(&scan);
+        return -1;
+    }
+
+    if (scan.count == 0) {
+        freeLeafScan(&scan);
+        return 0;
+    }
+
+    tasks = (scan.count + LEAVES_PER_TASK - 1) / LEAVES_PER_TASK;
+
+    scan.mask       = malloc(scan.count * sizeof(*scan.mask));
+    scan.partial    = malloc(tasks * sizeof(*scan.partial));
+
+    if (scan.mask == NULL || scan.partial == NULL) {
+        logError(ERROR_MEMORY_ALLOC);
+        freeLeafScan(&scan);
+        return -1;
+    }
+
+    if (runWorkerPool(scanLeafTask, &scan, tasks) != 0) {
+        freeLeafScan(&scan);
+        return -1;
+    }
+
+    for (index = 0; index < tasks; index++) {
+        totals->count   += scan.partial[index].count;
+        totals->income  += scan.partial[index].income;
+        totals->expense += scan.partial[index].expense;
+    }
+
+    /* if it fails, the program is scanned again next time */
+    addResultCache(&inex->result_cache, program, inex->generation, totals,
+        scan.leaf, scan.mask, scan.count);
+
+    if (visit != NULL) {
+        for (index = 0; index < scan.count; index++)
+            visit(scan.leaf[index], scan.mask[index], context);
+    }
+
+    freeLeafScan(&scan);
+
+    return 0;
+}
+
+
+/*
+ * Function to collect the leaves having records within the date range
+ * of program, from the leaf of its latest record
+ * (records outside [min_key, max_key] never match the program)
+ */
+static int collectScanLeaves(InexDataPtr inex, struct leafScan *scan)
+{
+    const StoreLeaf **leaves;
+    const StoreLeaf *leaf;
+    StorePos pos;
+    int capacity;
+
+    if (seekStoreDate(&inex->store, scan->program->max_key, &pos) != 0)
+        return 0;
+
+    for (leaf = pos.leaf; leaf != NULL; leaf = leaf->prev) {
+        if (leaf->date_key[leaf->count - 1] < scan->program->min_key)
+            break;
+
+        if (scan->count == scan->capacity) {
+            capacity = (scan->capacity > 0) ? scan->capacity * 2 : 64;
+
+            leaves = realloc(scan->leaf, capacity * sizeof(*leaves));
+            if (leaves == NULL) {
+                logError(ERROR_MEMORY_ALLOC);
+                return -1;
+            }
+
+            scan->leaf      = leaves;
+            scan->capacity  = capacity;
+        }
+
+        scan->leaf[scan->count++] = leaf;
+    }
+
+    return 0;
+}
+
+
+/*
+ * Task of the worker pool, to select and sum the leaves of the task
+ */
+static void scanLeafTask(void *context, int task)
+{
+    struct leafScan *scan = context;
+    const StoreLeaf *leaf;
+    StoreTotals totals;
+    int index, last;
+
+    memset(&totals, 0, sizeof(totals));
+
+    index   = task * LEAVES_PER_TASK;
+    last    = index + LEAVES_PER_TASK;
+
+    if (last > scan->count)
+        last = scan->count;
+
+    for (; index < last; index++) {
+        leaf = scan->leaf[index];
+
+        selectFilter(scan->program, leaf, scan->mask[index]);
+        totals.count += sumSelected(leaf->amount, leaf->info, leaf->count,
+            scan->mask[index], &totals.income, &totals.expense);
+    }
+
+    scan->partial[task] = totals;
+}
+
+
+static void freeLeafScan(struct leafScan *scan)
+{
+    free(scan->leaf);
+    free(scan->mask);
+    free(scan->partial);
+}
+
+
+/*
+ * Function to print the selected records of the leaf, latest record first
+ */
+static void printSelectedRecords(const StoreLeaf *leaf, const uint64_t *mask,
+        void *context)
+{
+    Record current;
+    StorePos pos;
+    uint64_t bits;
+    int word, bit;
+
+    pos.leaf = (StoreLeaf *) leaf;
+
+    for (word = MASK_WORDS(leaf->count) - 1; word >= 0; word--) {
+        bits = mask[word];
+
+        /* highest bit first, which is the latest record of the word */
+        while (bits != 0) {
+            bit     = MASK_BITS - 1 - __builtin_clzll(bits);
+            bits   &= ~((uint64_t) 1 << bit);
+
+            pos.index = word * MASK_BITS + bit;
+            getStoreRecord(&pos, &current);
+            printRecordInConsole(&current);
+        }
+    }
+}
+
+
+/*
+ * Visitor to print the selected records of the leaf within the row limit
+ * (offset rows are skipped first), from the latest record
+ */
+static void printLimitedRecords(const StoreLeaf *leaf, const uint64_t *mask,
+        void *context)
+{
+    struct rowLimit *rows = context;
+    Record current;
+    StorePos pos;
+    uint64_t bits;
+    int word, bit;
+
+    pos.leaf = (StoreLeaf *) leaf;
+
+    for (word = MASK_WORDS(leaf->count) - 1; word >= 0 && rows->limit > 0; word--) {
+        bits = mask[word];
+
+        while (bits != 0 && rows->limit > 0) {
+            bit     = MASK_BITS - 1 - __builtin_clzll(bits);
+            bits   &= ~((uint64_t) 1 << bit);
+
+            if (rows->offset > 0) {
+                rows->offset--;
+                continue;
+            }
+
+            pos.index = word * MASK_BITS + bit;
+            getStoreRecord(&pos, &current);
+            printRecordInConsole(&current);
+
+            rows->totals.count++;
+
+            if (current.r_info & 1) {
+                rows->totals.income += current.r_amount;
+            } else {
+                rows->totals.expense += current.r_amount;
+            }
+
+            rows->limit--;
+        }
+    }
+}
+
+
+/*
+ * Function to build the text index from all the records
+ */
+static int buildTextIndex(InexDataPtr inex)
+{
+    const StoreLeaf *leaf;
+    int index;
+
+    freeTextIndex(&inex->text_index);
+
+    for (leaf = inex->store.head; leaf != NULL; leaf = leaf->next) {
+        for (index = 0; index < leaf->count; index++) {
+            if (addTextIndex(&inex->text_index, leaf->id[index],
+                    leaf->entity[index], leaf->comment[index]) != 0) {
+                freeTextIndex(&inex->text_index);
+                return -1;
+            }
+        }
+    }
+
+    inex->text_indexed = 1;
+
+    return 0;
+}
+
+
+/*
+ * To drop the text index, when a change could not be applied
+ */
+static void dropTextIndex(InexDataPtr inex)
+{
+    freeTextIndex(&inex->text_index);
+    inex->text_indexed = 0;
+}
+
+
+/*
+ * Function to get the sorted ids of all the records
+ */
+static int allRecordIds(InexDataPtr inex, int **ids, int *count)
+{
+    const StoreLeaf *leaf;
+
+    *count  = 0;
+    *ids    = malloc((inex->store.count + 1) * sizeof(**ids));
+
+    if (*ids == NULL) {
+        logError(ERROR_MEMORY_ALLOC);
+        return -1;
+    }
+
+    for (leaf = inex->store.head; leaf != NULL; leaf = leaf->next) {
+        memcpy(*ids + *count, leaf->id, leaf->count * sizeof(**ids));
+        *count += leaf->count;
+    }
+
+    qsort(*ids, *count, sizeof(**ids), compareId);
+
+    return 0;
+}
+
+
+static int compareId(const void *a, const void *b)
+{
+    int x = *(const int *) a;
+    int y = *(const int *) b;
+
+    return (x > y) - (x < y);
+}
+
+
+/*
+ * Function to add the selected records of the leaf into their groups
+ */
+static void groupSelectedRecords(const StoreLeaf *leaf, const uint64_t *mask,
+        void *context)
+{
+    GroupTable *table = context;
+    uint64_t bits;
+    int word, bit, index;
+
+    for (word = 0; word < MASK_WORDS(leaf->count); word++) {
+        for (bits = mask[word]; bits != 0; bits &= bits - 1) {
+            bit     = __builtin_ctzll(bits);
+            index   = word * MASK_BITS + bit;
+
+            if (addGroupRecord(table, leaf->entity[index], leaf->date_key[index],
+                    leaf->info[index], leaf->amount[index]) != 0)
+                return;
+        }
+    }
+}
+
+
+/*
+ * Function to push the selected records of the leaf into the top heap
+ */
+static void pushSelectedRecords(const StoreLeaf *leaf, const uint64_t *mask,
+        void *context)
+{
+    TopHeap *heap = context;
+    TopEntry entry;
+    uint64_t bits;
+    int word;
+
+    entry.leaf = leaf;
+
+    for (word = 0; word < MASK_WORDS(leaf->count); word++) {
+        for (bits = mask[word]; bits != 0; bits &= bits - 1) {
+            entry.index     = word * MASK_BITS + __builtin_ctzll(bits);
+            entry.amount    = leaf->amount[entry.index];
+            entry.id        = leaf->id[entry.index];
+
+            pushTopHeap(heap, &entry);
+        }
+    }
+}
+
+
+/*
+ * Function to load the final change of every record in journal
+ * (memory of the overlay is in proportion to the entries of journal)
+ * same as the journal is applied on open, a date change (or add) places
+ * the record after the records of the same date
+ */
+static int loadJournalOverlay(struct journalOverlay *overlay,
+        const char *journalFileName)
+{
+    struct overlayRecord folded;
+    Journal journal;
+    int index, next, count = 0;
+
+    initJournal(&journal);
+
+    if (replayJournal(&journal, journalFileName, overlayJournalEntry, 
+            overlay) < 0) {
+        freeJournal(&journal);
+        return -1;
+    }
+
+    freeJournal(&journal);
+
+    if (overlay->count == 0)
+        return 0;
+
+    /* entries of a record are next to each other, in the journal order */
+    qsort(overlay->entry, overlay->count, sizeof(*overlay->entry), compareOverlay);
+
+    for (index = 0; index < overlay->count; index = next) {
+        memset(&folded, 0, sizeof(folded));
+
+        for (next = index; next < overlay->count 
+                && overlay->entry[next].rec.r_id == overlay->entry[index].rec.r_id;
+                next++) {
+            applyOverlay(&folded, &overlay->entry[next]);
+        }
+
+        overlay->entry[count++] = folded;
+    }
+
+    overlay->count = count;
+
+    for (index = 0; index < count; index++)
+        overlay->moved_count += (overlay->entry[index].state == OVERLAY_MOVE);
+
+    if (overlay->moved_count == 0)
+        return 0;
+
+    overlay->moved = malloc(overlay->moved_count * sizeof(*overlay->moved));
+    if (overlay->moved == NULL) {
+        logError(ERROR_MEMORY_ALLOC);
+        return -1;
+    }
+
+    overlay->moved_count = 0;
+
+    for (index = 0; index < count; index++) {
+        if (overlay->entry[index].state == OVERLAY_MOVE)
+            overlay->moved[overlay->moved_count++] = &overlay->entry[index];
+    }
+
+    qsort(overlay->moved, overlay->moved_count, sizeof(*overlay->moved),
+        compareMoved);
+
+    return 0;
+}
+
+
+/*
+ * Function to keep the journal entry (while loading the overlay)
+ */
+static int overlayJournalEntry(void *context, int operation, const Record *rec)
+{
+    struct journalOverlay *overlay = context;
+    struct overlayRecord *entry;
+    int capacity;
+
+    if (overlay->count == overlay->capacity) {
+        capacity = (overlay->capacity > 0) ? overlay->capacity * 2 : 64;
+
+        entry = realloc(overlay->entry, capacity * sizeof(*entry));
+        if (entry == NULL) {
+            logError(ERROR_MEMORY_ALLOC);
+            return -1;
+        }
+
+        overlay->entry      = entry;
+        overlay->capacity   = capacity;
+    }
+
+    entry = &overlay->entry[overlay->count];
+
+    entry->operation    = operation;
+    entry->state        = 0;
+    entry->seq          = overlay->count++;
+    entry->rec          = *rec;
+
+    return 0;
+}
+
+
+/*
+ * Function to apply a journal entry over the change of the record
+ * (entries which are skipped on open, are skipped here too)
+ */
+static void applyOverlay(struct overlayRecord *record,
+        const struct overlayRecord *change)
+{
+    switch (change->operation) {
+        case JOURNAL_ADD:
+            if (record->state == OVERLAY_EDIT || record->state == OVERLAY_MOVE)
+                return;
+
+            record->state   = OVERLAY_MOVE;
+            record->seq     = change->seq;
+            break;
+
+        case JOURNAL_EDIT:
+            if (record->state == OVERLAY_DELETE)
+                return;
+
+            if (record->state == 0)
+                record->state = OVERLAY_EDIT;
+            break;
+
+        case JOURNAL_EDIT_DATE:
+            if (record->state == OVERLAY_DELETE)
+                return;
+
+            record->state   = OVERLAY_MOVE;
+            record->seq     = change->seq;
+            break;
+
+        case JOURNAL_DELETE:
+            record->state   = OVERLAY_DELETE;
+            break;
+
+        default:
+            return;
+    }
+
+    record->rec = change->rec;
+}
+
+
+/*
+ * Function to find the change of the record (binary search by id)
+ *
+ * Return NULL, if record is not changed by the journal
+ */
+static const struct overlayRecord *findOverlay(
+        const struct journalOverlay *overlay, int record_id)
+{
+    int low     = 0;
+    int high    = overlay->count - 1;
+    int mid;
+
+    while (low <= high) {
+        mid = low + (high - low) / 2;
+
+        if (overlay->entry[mid].rec.r_id == record_id)
+            return &overlay->entry[mid];
+
+        if (overlay->entry[mid].rec.r_id < record_id)
+            low = mid + 1;
+        else
+            high = mid - 1;
+    }
+
+    return NULL;
+}
+
+
+static void freeJournalOverlay(struct journalOverlay *overlay)
+{
+    free(overlay->entry);
+    free(overlay->moved);
+    memset(overlay, 0, sizeof(*overlay));
+}
+
+
+static int compareOverlay(const void *a, const void *b)
+{
+    const struct overlayRecord *x = a;
+    const struct overlayRecord *y = b;
+
+    if (x->rec.r_id != y->rec.r_id)
+        return (x->rec.r_id > y->rec.r_id) - (x->rec.r_id < y->rec.r_id);
+
+    return (x->seq > y->seq) - (x->seq < y->seq);
+}
+
+
+static int compareMoved(const void *a, const void *b)
+{
+    const struct overlayRecord *x = *(const struct overlayRecord * const *) a;
+    const struct overlayRecord *y = *(const struct overlayRecord * const *) b;
+    DateKey x_key = DATE_KEY(x->rec.r_date);
+    DateKey y_key = DATE_KEY(y->rec.r_date);
+
+    if (x_key != y_key)
+        return (x_key > y_key) - (x_key < y_key);
+
+    return (x->seq > y->seq) - (x->seq < y->seq);
+}
+
+
+/*
+ * Function to print the records of file matching the program, from the
+ * latest record (records placed by the journal are merged by date)
+ *
+ * every chunk of the file is selected a leaf sized part at a time,
+ * records changed by the journal are checked one by one
+ */
+static int streamRecords(FILE *fp, int count, const FilterProgram *program,
+        const struct journalOverlay *overlay, StoreTotals *totals)
+{
+    const struct overlayRecord *change;
+    uint64_t mask[MASK_WORDS(LEAF_CAPACITY)];
+    StoreStream stream;
+    StoreLeaf part;
+    StorePos pos;
+    Record current;
+    DateKey key;
+    int start, end, index, moved, returnCode;
+    int done = 0;
+
+    memset(totals, 0, sizeof(*totals));
+
+    if (openStoreStream(&stream, fp, count, program->max_key) != 0)
+        return -1;
+
+    /* records placed by the journal, from the latest not after max_key */
+    for (moved = overlay->moved_count - 1; moved >= 0
+            && DATE_KEY(overlay->moved[moved]->rec.r_date) > program->max_key;
+            moved--);
+
+    pos.leaf = &stream.chunk;
+
+    while (done == 0 && (returnCode = readStoreStream(&stream)) == 0) {
+        for (end = stream.chunk.count; done == 0 && end > 0; end = start) {
+            start = (end > LEAF_CAPACITY) ? end - LEAF_CAPACITY : 0;
+
+            part            = stream.chunk;
+            part.count      = end - start;
+            part.id        += start;
+            part.info      += start;
+            part.date_key  += start;
+            part.amount    += start;
+            part.entity    += start;
+            part.comment   += start;
+
+            selectFilter(program, &part, mask);
+
+            for (index = end - 1; index >= start; index--) {
+                key = stream.chunk.date_key[index];
+
+                queryMovedRecords(program, overlay, &moved, key, totals);
+
+                if (key < program->min_key) {
+                    done = 1;
+                    break;
+                }
+
+                change = (overlay->count > 0)
+                    ? findOverlay(overlay, stream.chunk.id[index]) : NULL;
+
+                if (change != NULL) {
+                    if (change->state == OVERLAY_EDIT 
+                            && matchRecord(program, &change->rec))
+                        printQueryRecord(&change->rec, totals);
+                    continue;
+                }
+
+                if (mask[(index - start) / MASK_BITS] 
+                        & ((uint64_t) 1 << ((index - start) % MASK_BITS))) {
+                    pos.index = index;
+                    getStoreRecord(&pos, &current);
+                    printQueryRecord(&current, totals);
+                }
+            }
+        }
+    }
+
+    closeStoreStream(&stream);
+
+    if (returnCode < 0)
+        return -1;
+
+    queryMovedRecords(program, overlay, &moved, program->min_key, totals);
+
+    return 0;
+}
+
+
+/*
+ * Function to print the records placed by the journal, which are
+ * after (or same date as) the given key (moved is updated)
+ */
+static void queryMovedRecords(const FilterProgram *program,
+        const struct journalOverlay *overlay, int *moved, DateKey key,
+        StoreTotals *totals)
+{
+    const Record *rec;
+
+    for (; *moved >= 0; (*moved)--) {
+        rec = &overlay->moved[*moved]->rec;
+
+        if (DATE_KEY(rec->r_date) < key)
+            break;
+
+        if (matchRecord(program, rec))
+            printQueryRecord(rec, totals);
+    }
+}
+
+
+/*
+ * Function to check a single record for the program
+ */
+static int matchRecord(const FilterProgram *program, const Record *rec)
+{
+    uint64_t mask[MASK_WORDS(LEAF_CAPACITY)];
+    StoreLeaf leaf;
+    int id, info;
+    DateKey key;
+    long amount;
+
+    id      = rec->r_id;
+    info    = rec->r_info;
+    key     = DATE_KEY(rec->r_date);
+    amount  = rec->r_amount;
+
+    memset(&leaf, 0, sizeof(leaf));
+
+    leaf.count      = 1;
+    leaf.id         = &id;
+    leaf.info       = &info;
+    leaf.date_key   = &key;
+    leaf.amount     = &amount;
+    leaf.entity     = (char (*)[ENTITY_LEN]) rec->r_entity;
+    leaf.comment    = (char (*)[COMMENT_LEN]) rec->r_comment;
+
+    selectFilter(program, &leaf, mask);
+
+    return (int) (mask[0] & 1);
+}
+
+
+static void printQueryRecord(const Record *rec, StoreTotals *totals)
+{
+    totals->count++;
+
+    if (rec->r_info & 1) {
+        totals->income += rec->r_amount;
+    } else {
+        totals->expense += rec->r_amount;
+    }
+
+    printRecordInConsole(rec);
+}
+
+
+/*
+ * To write the records of the leaf selected by mask (all, if NULL)
+ * into export, from the oldest
+ */
+static int exportLeafRecords(ExportWriter *writer, const StoreLeaf *leaf,
+        const uint64_t *mask)
+{
+    Record current;
+    StorePos pos;
+
+    pos.leaf = (StoreLeaf *) leaf;
+
+    for (pos.index = 0; pos.index < leaf->count; pos.index++) {
+        if (mask != NULL && (mask[pos.index / MASK_BITS] 
+                & ((uint64_t) 1 << (pos.index % MASK_BITS))) == 0)
+            continue;
+
+        getStoreRecord(&pos, &current);
+
+        if (writeExportRecord(writer, &current) != 0)
+            return -1;
+    }
+
+    return 0;
+}
+
+
+/*
+ * Function to read all the records of the file into batch,
+ * record id is given (in the order of the file) and record is validated
+ *
+ * Return = 0, indicates success
+ * Return = 2, indicates invalid record (line no in reader)
+ * Return = 3, indicates application limit is reached
+ * Return < 0, indicates error
+ */
+static int readImportBatch(InexDataPtr inex, ImportReader *reader,
+        Record **batch, int *count)
+{
+    Record *grown;
+    int capacity = 0;
+    int returnCode;
+    long income     = inex->meta.md_total_income;
+    long expense    = inex->meta.md_total_expense;
+
+    for (*count = 0; ; (*count)++) {
+        if (*count == capacity) {
+            capacity    = (capacity > 0) ? capacity * 2 : 1024;
+            grown       = realloc(*batch, capacity * sizeof(**batch));
+
+            if (grown == NULL) {
+                logError(ERROR_MEMORY_ALLOC);
+                return -1;
+            }
+
+            *batch = grown;
+        }
+
+        returnCode = readImportRecord(reader, &(*batch)[*count]);
+        if (returnCode == 1)
+            return 0;
+
+        if (returnCode != 0)
+            return returnCode;
+
+        /* same limits as adding a record */
+        if (*count >= INT_MAX - inex->meta.md_counter)
+            return 3;
+
+        (*batch)[*count].r_id = inex->meta.md_counter + *count;
+
+        if (isValidRecord(&(*batch)[*count]) == 0)
+            return 2;
+
+        if ((*batch)[*count].r_info & 1) {
+            income += (*batch)[*count].r_amount;
+        } else {
+            expense += (*batch)[*count].r_amount;
+        }
+
+        if (LONG_MAX - income <= MAX_AMOUNT || LONG_MAX - expense <= MAX_AMOUNT)
+            return 3;
+    }
+}
+
+
+/*
+ * Function to merge the batch into the records (sorted by date,
+ * records of the same date in the order of the file),
+ * meta data, rollups, text index and journal are updated for the batch
+ */
+static int mergeImportBatch(InexDataPtr inex, Record *batch, int count)
+{
+    const Record **order;
+    uint64_t *key;
+    Record *rec;
+    long income     = 0;
+    long expense    = 0;
+    int index;
+
+    if (count == 0)
+        return 0;
+
+    key     = malloc(count * sizeof(*key));
+    order   = malloc(count * sizeof(*order));
+
+    if (key == NULL || order == NULL) {
+        logError(ERROR_MEMORY_ALLOC);
+        free(key);
+        free(order);
+        return -1;
+    }
+
+    /* date key in the high half, so that the file order is kept for a date */
+    for (index = 0; index < count; index++)
+        key[index] = ((uint64_t) DATE_KEY(batch[index].r_date) << 32) | index;
+
+    qsort(key, count, sizeof(*key), compareImportKey);
+
+    for (index = 0; index < count; index++)
+        order[index] = &batch[key[index] & UINT32_MAX];
+
+    free(key);
+
+    if (mergeStoreRecords(&inex->store, order, count) != 0) {
+        free(order);
+        return -1;
+    }
+
+    free(order);
+
+    /* a large batch is written by saving the whole file, not the journal */
+    if (count > JOURNAL_COMPACT_MIN)
+        inex->full_save = 1;
+
+    for (index = 0; index < count; index++) {
+        rec = &batch[index];
+
+        if (rec->r_info & 1) {
+            income += rec->r_amount;
+        } else {
+            expense += rec->r_amount;
+        }
+
+        applyRollup(&inex->rollup, DATE_KEY(rec->r_date), rec->r_info, 
+            rec->r_amount, 1);
+
+        if (inex->text_indexed && addTextIndex(&inex->text_index, rec->r_id,
+                rec->r_entity, rec->r_comment) != 0)
+            dropTextIndex(inex);
+
+        if (inex->full_save == 0)
+            appendJournal(&inex->journal, JOURNAL_ADD, rec);
+    }
+
+    /* meta data is updated once, for the whole batch */
+    inex->meta.md_counter           += count;
+    inex->meta.md_record_count      += count;
+    inex->meta.md_total_income      += income;
+    inex->meta.md_total_expense     += expense;
+
+    inex->generation++;
+
+    return 0;
+}
+
+
+static int compareImportKey(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *) a;
+    uint64_t y = *(const uint64_t *) b;
+
+    return (x > y) - (x < y);
+}
\ No newline at end of file
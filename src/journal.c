@@ -0,0 +1,263 @@
+/*
+ * journal.c
+ *
+ * Append only journal of the record changes (write ahead of the InEx file)
+ *
+ *  Created on: 16-Oct-2026
+ *      Author: deepaks
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "headers/journal.h"
+#include "headers/customError.h"
+
+#define JOURNAL_HEADER_LEN  32
+#define MIN_CAPACITY        64
+
+
+static unsigned int entryChecksum(const JournalEntry *entry);
+
+
+static const char *journal_header_name = "inex-journal-v1";
+
+
+/*
+ * To initialize an empty journal
+ */
+void initJournal(Journal *journal)
+{
+    if (journal == NULL)
+        return;
+
+    memset(journal, 0, sizeof(*journal));
+}
+
+
+/*
+ * To free the buffered entries of the journal
+ */
+void freeJournal(Journal *journal)
+{
+    if (journal == NULL)
+        return;
+
+    free(journal->entry);
+    initJournal(journal);
+}
+
+
+/*
+ * Function to buffer a change, until the journal is flushed
+ *
+ * Return = 0, indicates success
+ * Return < 0, indicates error (journal is marked as lost)
+ */
+int appendJournal(Journal *journal, int operation, const Record *rec)
+{
+    JournalEntry *entry;
+    int capacity;
+
+    if (journal == NULL || rec == NULL) {
+        logError(ERROR_FUNC_ARG);
+        return -2;
+    }
+
+    if (journal->count == journal->capacity) {
+        capacity = (journal->capacity > 0) ? journal->capacity * 2 : MIN_CAPACITY;
+
+        entry = realloc(journal->entry, capacity * sizeof(*entry));
+        if (entry == NULL) {
+            logError(ERROR_MEMORY_ALLOC);
+            journal->lost = 1;
+            return -1;
+        }
+
+        journal->entry      = entry;
+        journal->capacity   = capacity;
+    }
+
+    entry = &journal->entry[journal->count];
+
+    memset(entry, 0, sizeof(*entry));
+    memcpy(&entry->je_record, rec, sizeof(*rec));
+    entry->je_operation = operation;
+    entry->je_checksum  = entryChecksum(entry);
+
+    journal->count++;
+
+    return 0;
+}
+
+
+/*
+ * Function to append the buffered entries into the journal file
+ * file is synced, before the entries are released
+ *
+ * Return = 0, indicates success
+ * Return < 0, indicates error
+ */
+int flushJournal(Journal *journal, const char *journalFileName)
+{
+    char header[JOURNAL_HEADER_LEN] = {0};
+    FILE *fp;
+    int returnCode = 0;
+
+    if (journal == NULL || journalFileName == NULL) {
+        logError(ERROR_FUNC_ARG);
+        return -2;
+    }
+
+    if (journal->count == 0)
+        return 0;
+
+    fp = fopen(journalFileName, "ab");
+    if (fp == NULL) {
+        logError(ERROR_FILE_OPEN);
+        return -3;
+    }
+
+    /* new journal file starts with the header */
+    if (fseek(fp, 0, SEEK_END) != 0 || ftell(fp) == 0) {
+        strncpy(header, journal_header_name, JOURNAL_HEADER_LEN);
+
+        if (fwrite(header, JOURNAL_HEADER_LEN, 1, fp) != 1)
+            returnCode = -1;
+    }
+
+    if (returnCode == 0 && fwrite(journal->entry, sizeof(*journal->entry),
+            journal->count, fp) != (size_t) journal->count)
+        returnCode = -1;
+
+    if (returnCode == 0 && (fflush(fp) != 0 || fsync(fileno(fp)) != 0))
+        returnCode = -1;
+
+    if (fclose(fp) != 0)
+        returnCode = -1;
+
+    if (returnCode != 0) {
+        logError(ERROR_FILE_WRITE);
+        return returnCode;
+    }
+
+    journal->file_entries  += journal->count;
+    journal->count          = 0;
+
+    return 0;
+}
+
+
+/*
+ * Function to apply all the entries of the journal file (oldest first)
+ * a partly written entry at the end (if any) is ignored
+ *
+ * Return = 0, indicates success (or no journal file)
+ * Return > 0, indicates the journal file has a broken tail
+ * Return < 0, indicates error
+ */
+int replayJournal(Journal *journal, const char *journalFileName,
+        JournalReplay replay, void *context)
+{
+    char header[JOURNAL_HEADER_LEN];
+    JournalEntry entry;
+    FILE *fp;
+    long size;
+    int returnCode = 0;
+
+    if (journal == NULL || journalFileName == NULL || replay == NULL) {
+        logError(ERROR_FUNC_ARG);
+        return -2;
+    }
+
+    fp = fopen(journalFileName, "rb");
+    if (fp == NULL)
+        return 0;
+
+    if (fseek(fp, 0, SEEK_END) != 0 || (size = ftell(fp)) < 0
+            || fseek(fp, 0, SEEK_SET) != 0) {
+        logError(ERROR_FILE_READ);
+        fclose(fp);
+        return -1;
+    }
+
+    if (fread(header, JOURNAL_HEADER_LEN, 1, fp) != 1
+            || strncmp(header, journal_header_name, JOURNAL_HEADER_LEN) != 0) {
+        fclose(fp);
+        return 1;
+    }
+
+    /* some bytes at the end, which are not a complete entry */
+    if ((size - JOURNAL_HEADER_LEN) % sizeof(entry) != 0)
+        returnCode = 1;
+
+    while (fread(&entry, sizeof(entry), 1, fp) == 1) {
+        if (entry.je_checksum != entryChecksum(&entry)) {
+            returnCode = 1;
+            break;
+        }
+
+        if (replay(context, entry.je_operation, &entry.je_record) < 0) {
+            returnCode = -1;
+            break;
+        }
+
+        journal->file_entries++;
+    }
+
+    if (returnCode == 0 && ferror(fp)) {
+        logError(ERROR_FILE_READ);
+        returnCode = -1;
+    }
+
+    fclose(fp);
+
+    return returnCode;
+}
+
+
+/*
+ * Function to remove the journal file, after its changes are in the InEx file
+ * buffered entries are not removed
+ */
+int removeJournal(Journal *journal, const char *journalFileName)
+{
+    if (journal == NULL || journalFileName == NULL) {
+        logError(ERROR_FUNC_ARG);
+        return -2;
+    }
+
+    journal->file_entries = 0;
+
+    if (remove(journalFileName) != 0 && access(journalFileName, F_OK) == 0) {
+        logError(ERROR_FILE_REMOVE);
+        return -1;
+    }
+
+    return 0;
+}
+
+
+/*
+ * Function to calculate the checksum (FNV-1a) of an entry
+ * checksum field itself is taken as zero
+ */
+static unsigned int entryChecksum(const JournalEntry *entry)
+{
+    JournalEntry temp;
+    const unsigned char *byte = (const unsigned char *) &temp;
+    unsigned int hash = 2166136261u;
+    size_t index;
+
+    memcpy(&temp, entry, sizeof(temp));
+    temp.je_checksum = 0;
+
+    for (index = 0; index < sizeof(temp); index++) {
+        hash ^= byte[index];
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
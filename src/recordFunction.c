@@ -11,19 +11,26 @@
 
 #include "headers/recordFunction.h"
 #include "headers/consoleInput.h"
+#include "headers/renderBuffer.h"
 
 #define BUFFER_LEN  32  // Should be greater than the below macro values
 #define DATE_LEN    11
 #define AMOUNT_LEN  22
 
 
-static int isValidStringAmount(const char *str);
 static int isValidDateField(int year, int month, int day);
 static void printCommentInConsole(const char *comment);
+static int formatUnsigned(char *str, unsigned long value);
 
 
 static char buffer[BUFFER_LEN];
 
+/* "00" to "99", two digits are written at once while formatting */
+static const char digit_pairs[201] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
 static const char *record_header =
     "\n\t<------LIST OF RECORDS------>\n";
 static const char *header_column_text = 
@@ -133,7 +140,8 @@ int getRecordFromConsole(Record *rec, int mandatoryCheck)
 
 
 /*
- * Function to parse string into Date
+ * Function to parse string into Date (yyyy-mm-dd, month and day 
+ * can be of one digit), digits are converted while the format is checked
  *
  * Return = 0 - Success
  * Return > 0 - Invalid input scenario
@@ -141,21 +149,52 @@ int getRecordFromConsole(Record *rec, int mandatoryCheck)
  */
 int parseStringToDate(const char *str, Date *date)
 {
+    static const int max_digits[3] = {4, 2, 2};
+    int field[3] = {0, 0, 0};
+    int part = 0, digits = 0;
+
     if (str == NULL || date == NULL)
         return -1;
 
-    if (sscanf(str, "%d-%d-%d", &date->year, &date->month, &date->day) == 3) {
-        if (isValidDate(date)) {
-            return 0;
+    for (;; str++) {
+        if (*str >= '0' && *str <= '9') {
+            if (++digits > max_digits[part])
+                return 1;
+
+            field[part] = field[part] * 10 + (*str - '0');
+            continue;
+        }
+
+        if (digits == 0)
+            return 1;
+
+        if (*str == '-' && part < 2) {
+            part++;
+            digits = 0;
+            continue;
         }
+
+        if (*str == '\0' && part == 2)
+            break;
+
+        return 1;
     }
 
+    date->year  = field[0];
+    date->month = field[1];
+    date->day   = field[2];
+
+    if (isValidDate(date))
+        return 0;
+
     return 1;
 }
 
 
 /*
- * Function to parse string into amount
+ * Function to parse string into amount (in paise), the format is 
+ * digits with optional two decimal places, like 1234 or 1234.05
+ * digits are converted while the format is checked
  *
  * Return = 0 - Success
  * Return > 0 - Invalid input scenario
@@ -163,23 +202,39 @@ int parseStringToDate(const char *str, Date *date)
  */
 int parseStringToAmount(const char *str, long *amount) 
 {
-    long temp_main = 0;
-    long temp_deci = 0;
+    long value = 0;
+    int index = 0;
 
     if (str == NULL || amount == NULL) 
         return -1;
 
-    if (isValidStringAmount(str) == 0)
+    /* at most 15 characters, so that value cannot overflow */
+    while (str[index] >= '0' && str[index] <= '9' && index < 15) {
+        value = value * 10 + (str[index] - '0');
+        index++;
+    }
+
+    if (index == 0)
+        return 1;
+
+    value *= 100;
+
+    if (str[index] == '.') {
+        if (index > 12 || str[index + 1] < '0' || str[index + 1] > '9'
+                || str[index + 2] < '0' || str[index + 2] > '9')
+            return 1;
+
+        value += (str[index + 1] - '0') * 10 + (str[index + 2] - '0');
+        index += 3;
+    }
+
+    if (str[index] != '\0')
         return 1;
-    
-    if (sscanf(str, "%ld.%ld", &temp_main, &temp_deci) <= 0) 
-        return 2;
 
-    if (temp_main < 0 || temp_main > 999999999999 ||
-            temp_deci < 0 || temp_deci > 99) 
+    if (value > MAX_AMOUNT)
         return 3;
 
-    *amount = (temp_main * 100) + temp_deci;
+    *amount = value;
 
     return 0;
 } 
@@ -299,138 +354,172 @@ int isValidRecordComment(const Record *rec) {
 
 
 /*
- * return value of non-zero, indicates Yes or Success 
+ * Function to unpack the date key into date
  */
-int isRecordBetweenDateRange(const Record *rec, Date *d1, Date *d2)
+Date keyToDate(DateKey key)
 {
-    if (rec == NULL)
-        return 0;
+    Date date;
 
-    /* Both upper and lower limit cannot be ignored with dot(.) */
-    if (d1 == NULL && d2 == NULL)
-        return 0;
-
-    if (d1 != NULL) {
-        /* if record data is lower than the lower limit, fail */
-        if (compareDate(rec->r_date, *d1) < 0)
-            return 0;
-    }
-
-    if (d2 != NULL) {
-        /* if record data is upper than the upper limit, fail */
-        if (compareDate(rec->r_date, *d2) > 0)
-            return 0;
-    }
+    date.year   = KEY_YEAR(key);
+    date.month  = KEY_MONTH(key);
+    date.day    = KEY_DAY(key);
 
-    return 1;
-} 
+    return date;
+}
 
 
 /*
- * return value of non-zero, indicates Yes or Success 
+ * Function to copy values from source record to destination record
  */
-int isRecordBetweenAmountRange(const Record *rec, long *a1, long *a2)
+int copyRecord(Record *dest, Record *src) 
 {
-    if (rec == NULL)
-        return 0;
-
-    /* Both upper and lower limit cannot be ignored with dot (.) */
-    if (a1 == NULL && a2 == NULL)
-        return 0;
-
-    if (a1 != NULL) {
-        /* if record data is lower than the lower limit, fail */
-        if (rec->r_amount < *a1)
-            return 0;
-    }
+    if (dest == NULL || src == NULL) 
+        return -1;
 
-    if (a2 != NULL) {
-        /* if record data is upper than the upper limit, fail */
-        if (rec->r_amount > *a2)
-            return 0;
-    }
+    /*
+     * The members of the 'Record' doesn't have pointers
+     * So, we can directly assign or use memcpy()
+     *
+     * Note: If pointers also as members, modify this implementation 
+     */
+    *dest = *src;
 
-    return 1;
+    return 0;
 } 
 
 
 /*
- * Function to compare two dates
+ * Function to format the amount (in paise) as decimal text, like "-1234.05"
+ * locale is not used, text is not null terminated
+ * str should have space for AMOUNT_TEXT_LEN characters
  *
- * if d1 > d2, return 1  (d1 is latest date)
- * if d1 < d2, return -1 (d2 is latest date)
- * if d1 = d2, return 0 
+ * Return the length of the text
  */
-int compareDate(Date d1, Date d2) 
+int formatAmount(char *str, long amount)
 {
-    if (d1.year > d2.year)
-        return 1;
-    if (d1.year < d2.year)
-        return -1;
+    unsigned long value;
+    int length = 0;
 
-    if (d1.month > d2.month)
-        return 1;
-    if (d1.month < d2.month)
-        return -1;
+    if (amount < 0) {
+        str[length++] = '-';
+        value = 0UL - (unsigned long) amount;
+    } else {
+        value = (unsigned long) amount;
+    }
 
-    if (d1.day > d2.day)
-        return 1;
-    if (d1.day < d2.day)
-        return -1;
+    length += formatUnsigned(str + length, value / 100);
 
-    return 0;
-} 
+    str[length++] = '.';
+    memcpy(str + length, &digit_pairs[(value % 100) * 2], 2);
+
+    return length + 2;
+}
 
 
 /*
- * Function to copy values from source record to destination record
+ * Function to format the date as "yyyy-mm-dd" (DATE_TEXT_LEN characters)
+ * date should be valid, text is not null terminated
+ *
+ * Return the length of the text
  */
-int copyRecord(Record *dest, Record *src) 
+int formatDate(char *str, const Date *date)
 {
-    if (dest == NULL || src == NULL) 
-        return -1;
+    memcpy(str, &digit_pairs[(date->year / 100) * 2], 2);
+    memcpy(str + 2, &digit_pairs[(date->year % 100) * 2], 2);
+    str[4] = '-';
+    memcpy(str + 5, &digit_pairs[date->month * 2], 2);
+    str[7] = '-';
+    memcpy(str + 8, &digit_pairs[date->day * 2], 2);
+
+    return DATE_TEXT_LEN;
+}
 
-    /*
-     * The members of the 'Record' doesn't have pointers
-     * So, we can directly assign or use memcpy()
-     *
-     * Note: If pointers also as members, modify this implementation 
-     */
-    *dest = *src;
 
-    return 0;
-} 
+/*
+ * Function to format the integer as decimal text (not null terminated)
+ *
+ * Return the length of the text
+ */
+int formatInteger(char *str, long value)
+{
+    if (value < 0) {
+        str[0] = '-';
+        return 1 + formatUnsigned(str + 1, 0UL - (unsigned long) value);
+    }
+
+    return formatUnsigned(str, (unsigned long) value);
+}
 
 
 /*
  * To print record in console with a line seperator at the end 
+ * record is formatted into render buffer (see flushRecordsInConsole)
  */
 int printRecordInConsole(const Record *rec) 
 {
-    static char type[4];
+    const char *type = " x ";
+    char row[160], amount[AMOUNT_TEXT_LEN];
+    int length = 0, width;
 
     if (rec == NULL) 
         return -1;
 
-    strcpy(type," x ");
-
     if (rec->r_info & 1)
-        strcpy(type,"+IN");
+        type = "+IN";
+
+    /* " %3s | %15s | yyyy-mm-dd | entity\n\n     ID      : id\n" */
+    row[length++] = ' ';
+    memcpy(row + length, type, 3);
+    length += 3;
+    memcpy(row + length, " | ", 3);
+    length += 3;
+
+    width = formatAmount(amount, rec->r_amount);
+    if (width < 15) {
+        memset(row + length, ' ', 15 - width);
+        length += 15 - width;
+    }
+    memcpy(row + length, amount, width);
+    length += width;
 
-    printf(" %3s | %12ld.%02ld | %04d-%02d-%02d | %s\n\n"
-        , type, (rec->r_amount / 100), (rec->r_amount % 100) 
-        , rec->r_date.year, rec->r_date.month, rec->r_date.day
-        , rec->r_entity);
+    memcpy(row + length, " | ", 3);
+    length += 3;
+    length += formatDate(row + length, &rec->r_date);
+    memcpy(row + length, " | ", 3);
+    length += 3;
+
+    width = strnlen(rec->r_entity, ENTITY_LEN - 1);
+    memcpy(row + length, rec->r_entity, width);
+    length += width;
+
+    memcpy(row + length, "\n\n     ID      : ", 17);
+    length += 17;
+    length += formatInteger(row + length, rec->r_id);
+    memcpy(row + length, "\n     COMMENT : ", 16);
+    length += 16;
+
+    renderText(row, length);
 
-    printf("     ID      : %d\n", rec->r_id);
-    printf("     COMMENT : ");
     printCommentInConsole(rec->r_comment);
-    printf("\n\n%s\n", row_seperator_text);
+
+    renderText("\n\n", 2);
+    renderText(row_seperator_text, strlen(row_seperator_text));
+    renderText("\n", 1);
 
     return 0;
 } 
 
 
+/*
+ * To write the records formatted so far into console,
+ * should be called before printing anything else after the records
+ */
+void flushRecordsInConsole() 
+{
+    flushRender();
+} 
+
+
 /*
  * to print record header including column name in console
  */
@@ -448,6 +537,7 @@ void printRecordHeaderInConsole()
  */
 void printRecordFooterInConsole() 
 {    
+    flushRender();
     puts(record_footer);
 } 
 
@@ -458,51 +548,20 @@ void printRecordFooterInConsole()
 void printCalculationInConsole(int no_of_rec, long income, long expense) 
 {
     long balance = income - expense;
+    char income_text[AMOUNT_TEXT_LEN + 1];
+    char expense_text[AMOUNT_TEXT_LEN + 1];
+    char balance_text[AMOUNT_TEXT_LEN + 1];
 
-    printf("\tNo of records : %d\n", no_of_rec);
-    printf("\tTotal Income  : %ld.%02ld\n", income / 100, income % 100);
-    printf("\tTotal Expense : %ld.%02ld\n", expense / 100, expense % 100);
-    printf("\tBalance       : %ld.%02ld\n", balance / 100,
-        (balance < 0) ? (balance % 100) * (-1) : (balance % 100));
-} 
-
+    income_text[formatAmount(income_text, income)]     = '\0';
+    expense_text[formatAmount(expense_text, expense)]  = '\0';
+    balance_text[formatAmount(balance_text, balance)]  = '\0';
 
-/*
- * To check if the string is in valid Amount format
- *
- * Return != 0 (non-zero), indicates valid format
- */ 
-static int isValidStringAmount(const char *str) 
-{
-    int i, point = 0, pos = 0;
-
-    if (str == NULL) 
-        return 0;
-
-    for (i = 0; str[i] != '\0'; i++) {
-        if (i >= 15)
-            return 0;
-
-        if (str[i] >= '0' && str[i] <= '9') 
-            continue;
+    flushRender();
 
-        if (str[i] == '.') {
-            point++;
-
-            if (point > 1)
-                return 0;
-
-            pos = i;
-            continue;
-        }
-
-        return 0;
-    }
-
-    if (point && (i - pos) != 3)
-        return 0;
-
-    return 1;
+    printf("\tNo of records : %d\n", no_of_rec);
+    printf("\tTotal Income  : %s\n", income_text);
+    printf("\tTotal Expense : %s\n", expense_text);
+    printf("\tBalance       : %s\n", balance_text);
 } 
 
 
@@ -539,22 +598,51 @@ static int isValidDateField(int year, int month, int day)
 
 /*
  * to print record comment in console with some format  
+ * (comment is wrapped for every 54 characters)
  */
 static void printCommentInConsole(const char *comment)
 {
-    int index = 0;
     static const char *blank_space =
         "\n               ";
+    int length, index;
 
     if (comment == NULL)
         return;
 
-    while (comment[index] != '\0') {
-        if (index % 54 == 0 && index != 0) 
-            printf("%s", blank_space);
+    length = strlen(comment);
 
-        printf("%c", comment[index]);
+    for (index = 0; index < length; index += 54) {
+        if (index != 0) 
+            renderText(blank_space, strlen(blank_space));
 
-        index++;
+        renderText(comment + index, (length - index < 54) ? length - index : 54);
+    }
+}
+
+
+/*
+ * To write the decimal digits of the value, two digits at a time
+ * (from the lowest digits, into a temporary buffer)
+ */
+static int formatUnsigned(char *str, unsigned long value)
+{
+    char digits[24];
+    int index = sizeof(digits);
+
+    while (value >= 100) {
+        index -= 2;
+        memcpy(digits + index, &digit_pairs[(value % 100) * 2], 2);
+        value /= 100;
     }
+
+    if (value >= 10) {
+        index -= 2;
+        memcpy(digits + index, &digit_pairs[value * 2], 2);
+    } else {
+        digits[--index] = (char) ('0' + value);
+    }
+
+    memcpy(str, digits + index, sizeof(digits) - index);
+
+    return sizeof(digits) - index;
 } 
\ No newline at end of file
@@ -0,0 +1,1969 @@
+/*
+ * recordStore.c
+ *
+ * Store of the records kept sorted by date, as a B+tree
+ * whose leaves are columnar blocks of records
+ *
+ *  Created on: 16-Oct-2026
+ *      Author: deepaks
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <sys/mman.h>
+
+#include "headers/recordStore.h"
+#include "headers/customError.h"
+#include "headers/recordFunction.h"
+#include "headers/scanKernel.h"
+
+#define NODE_CAPACITY   64
+#define NO_OF_COLUMN    6
+
+/* no of objects allocated together in a chunk of the slab */
+#define LEAF_PER_CHUNK  64
+#define BLOCK_PER_CHUNK 16
+#define NODE_PER_CHUNK  16
+
+/* width of the columns in file: id, info, date, amount, entity, comment */
+static const size_t column_width[NO_OF_COLUMN] = {
+    sizeof(int), sizeof(int), sizeof(DateKey), sizeof(long),
+    ENTITY_LEN, COMMENT_LEN
+};
+
+/* previous file format (v2), date is stored as Date (3 ints) */
+static const size_t v2_column_width[NO_OF_COLUMN] = {
+    sizeof(int), sizeof(int), sizeof(Date), sizeof(long),
+    ENTITY_LEN, COMMENT_LEN
+};
+
+/* To align the start of every column within the file */
+#define ALIGN_COLUMN(x) (((x) + 7) & ~((size_t) 7))
+
+/* no of records read at a time, by the stream of a store file */
+#define STREAM_CHUNK    (16 * LEAF_CAPACITY)
+
+/* memory needed for all the columns of a leaf */
+#define LEAF_BLOCK_SIZE (LEAF_CAPACITY * (sizeof(long) + 2 * sizeof(int) \
+    + sizeof(DateKey) + ENTITY_LEN + COMMENT_LEN))
+
+/*
+ * Inner node of the B+tree
+ * key[i] is the oldest date key of the child[i] (at the time it is linked),
+ * all the records of child[i] are same or latest than key[i]
+ */
+struct storeNode {
+    int                 count;
+    int                 leaf_level;     /* children are leaves */
+    DateKey             key[NODE_CAPACITY];
+    void                *child[NODE_CAPACITY];
+    struct storeNode    *parent;
+    StoreTotals         total;          /* totals of all the children */
+};
+
+
+/* leaf related functions */
+static StoreLeaf *createLeaf(RecordStore *store);
+static int ownLeaf(RecordStore *store, StoreLeaf *leaf);
+static void freeLeaf(RecordStore *store, StoreLeaf *leaf);
+static int isSharedLeaf(const RecordStore *store, const StoreLeaf *leaf);
+static int retireBlock(RecordStore *store, void *block);
+static void carveLeafColumns(StoreLeaf *leaf, char *block, int capacity);
+static void moveLeafRecords(StoreLeaf *dest, int dest_index,
+        const StoreLeaf *src, int src_index, int count);
+static void writeLeafRecord(StoreLeaf *leaf, int index, const Record *rec);
+static StoreLeaf *mergeLeaves(RecordStore *store, const StoreLeaf *src,
+        const Record **batch, int count);
+static int splitLeaf(RecordStore *store, StoreLeaf *leaf, DateKey key,
+        StorePos *pos);
+static void linkLeafAfter(RecordStore *store, StoreLeaf *leaf, StoreLeaf *next);
+static void unlinkLeaf(RecordStore *store, StoreLeaf *leaf);
+static int upperBoundLeaf(const StoreLeaf *leaf, DateKey key);
+
+/* inner node related functions */
+static StoreLeaf *descendStore(const RecordStore *store, DateKey key);
+static int insertChild(RecordStore *store, struct storeNode *node, int index,
+        void *child, DateKey key);
+static void removeChild(RecordStore *store, struct storeNode *node, int index);
+static struct storeNode *createNode(RecordStore *store, int leaf_level);
+static int childIndex(const struct storeNode *node, const void *child);
+static void setParent(void *child, int leaf_level, struct storeNode *parent);
+static DateKey oldestKey(const void *child, int leaf_level);
+static int buildStoreNodes(RecordStore *store);
+
+/* totals related functions */
+static void addTotals(StoreTotals *totals, const StoreTotals *add, int sign);
+static void addRecordTotals(StoreTotals *totals, int info, long amount, int sign);
+static void updateTotals(RecordStore *store, StoreLeaf *leaf, int index, int sign);
+static void sumLeafTotals(const StoreLeaf *leaf, int from, int to, 
+        StoreTotals *totals);
+static void sumNodeTotals(struct storeNode *node);
+static void refreshTotals(struct storeNode *node);
+static void buildStoreTotals(RecordStore *store);
+static void prefixTotals(const RecordStore *store, DateKey key, 
+        StoreTotals *totals);
+
+/* other functions */
+static int writeLeafList(const StoreLeaf *head, int count, FILE *fp);
+static void columnOffsets(int count, const size_t *width, size_t *offset);
+static void *leafColumn(const StoreLeaf *leaf, int column, size_t *width);
+static int indexLeaf(RecordStore *store, StoreLeaf *leaf, int from);
+
+
+/*
+ * To initialize an empty store
+ */
+void initRecordStore(RecordStore *store)
+{
+    if (store == NULL)
+        return;
+
+    memset(store, 0, sizeof(*store));
+
+    initSlab(&store->leaf_slab, sizeof(StoreLeaf), LEAF_PER_CHUNK);
+    initSlab(&store->block_slab, LEAF_BLOCK_SIZE, BLOCK_PER_CHUNK);
+    initSlab(&store->node_slab, sizeof(struct storeNode), NODE_PER_CHUNK);
+}
+
+
+/*
+ * To free all the leaves, nodes (and mapping) of the store
+ * leaves, blocks and nodes are freed together, chunk by chunk
+ * Note: caller should release the snapshot (if any) before this
+ */
+void freeRecordStore(RecordStore *store)
+{
+    if (store == NULL)
+        return;
+
+    destroySlab(&store->leaf_slab);
+    destroySlab(&store->block_slab);
+    destroySlab(&store->node_slab);
+
+    free(store->retired);
+
+    if (store->map_base != NULL)
+        munmap(store->map_base, store->map_length);
+
+    freeIdIndex(&store->id_index);
+    initRecordStore(store);
+}
+
+
+/*
+ * Function to insert the record into the correct position (based on date)
+ * new record is placed after the existing records of the same date
+ *
+ * Return = 0, indicates success
+ * Return < 0, indicates error
+ */
+int insertStoreRecord(RecordStore *store, const Record *rec)
+{
+    StoreLeaf *leaf;
+    StorePos pos;
+    DateKey key;
+
+    if (store == NULL || rec == NULL) {
+        logError(ERROR_FUNC_ARG);
+        return -2;
+    }
+
+    key = DATE_KEY(rec->r_date);
+
+    /* first record, tree with one node and one leaf */
+    if (store->root == NULL) {
+        store->root = createNode(store, 1);
+        leaf        = createLeaf(store);
+
+        if (store->root == NULL || leaf == NULL) {
+            freeSlab(&store->node_slab, store->root);
+            freeLeaf(store, leaf);
+            store->root = NULL;
+            return -1;
+        }
+
+        insertChild(store, store->root, 0, leaf, key);
+        linkLeafAfter(store, NULL, leaf);
+    }
+
+    /* latest records are mostly added, so check the tail first */
+    leaf = store->tail;
+
+    if (leaf->count == 0
+            || key >= leaf->date_key[leaf->count - 1]) {
+        pos.leaf    = leaf;
+        pos.index   = leaf->count;
+    } else {
+        pos.leaf    = descendStore(store, key);
+        pos.index   = upperBoundLeaf(pos.leaf, key);
+    }
+
+    if (ownLeaf(store, pos.leaf) != 0)
+        return -1;
+
+    if (pos.leaf->count == LEAF_CAPACITY) {
+        if (splitLeaf(store, pos.leaf, key, &pos) != 0)
+            return -1;
+    }
+
+    leaf = pos.leaf;
+
+    moveLeafRecords(leaf, pos.index + 1, leaf, pos.index, leaf->count - pos.index);
+    writeLeafRecord(leaf, pos.index, rec);
+    leaf->count++;
+    store->count++;
+
+    updateTotals(store, leaf, pos.index, 1);
+
+    /* record is already added, index is built again on the next lookup */
+    if (store->indexed && putIdIndex(&store->id_index, rec->r_id, leaf) != 0) {
+        freeIdIndex(&store->id_index);
+        store->indexed = 0;
+    }
+
+    return 0;
+}
+
+
+/*
+ * Function to merge the batch of records (sorted by date) into the store
+ * in one pass, every record is placed after the existing records of the 
+ * same date (and after the previous records of the batch)
+ *
+ * leaves from the oldest date of the batch are written again (full),
+ * older leaves are not touched; inner nodes are built again
+ *
+ * Return = 0, indicates success
+ * Return < 0, indicates error (store is not changed)
+ */
+int mergeStoreRecords(RecordStore *store, const Record **batch, int count)
+{
+    StoreLeaf *start, *merged, *leaf, *next, *prev, *old_tail;
+    struct storeNode *old_root;
+    Slab old_slab;
+    StorePos pos;
+
+    if (store == NULL || batch == NULL || count < 0) {
+        logError(ERROR_FUNC_ARG);
+        return -2;
+    }
+
+    if (count == 0)
+        return 0;
+
+    /* leaf of the latest record, which is not after the batch */
+    start = store->head;
+
+    if (seekStoreDate(store, DATE_KEY(batch[0]->r_date), &pos) == 0)
+        start = pos.leaf;
+
+    merged = mergeLeaves(store, start, batch, count);
+    if (merged == NULL)
+        return -1;
+
+    /* 
+     * merged leaves replace the leaves from start, and the nodes are 
+     * built in a new slab; old leaves and nodes are kept until it is done
+     */
+    prev        = (start != NULL) ? start->prev : store->tail;
+    old_tail    = store->tail;
+    old_root    = store->root;
+    old_slab    = store->node_slab;
+
+    for (leaf = merged; leaf->next != NULL; leaf = leaf->next)
+        ;
+
+    merged->prev = prev;
+    if (prev != NULL) {
+        prev->next = merged;
+    } else {
+        store->head = merged;
+    }
+
+    store->tail = leaf;
+    initSlab(&store->node_slab, sizeof(struct storeNode), NODE_PER_CHUNK);
+
+    if (buildStoreNodes(store) != 0) {
+        for (leaf = merged; leaf != NULL; leaf = next) {
+            next = leaf->next;
+            freeLeaf(store, leaf);
+        }
+
+        if (prev != NULL) {
+            prev->next = start;
+        } else {
+            store->head = start;
+        }
+
+        store->tail = old_tail;
+        store->root = old_root;
+        destroySlab(&store->node_slab);
+        store->node_slab = old_slab;
+
+        return -1;
+    }
+
+    for (leaf = start; leaf != NULL; leaf = next) {
+        next = leaf->next;
+        freeLeaf(store, leaf);
+    }
+
+    destroySlab(&old_slab);
+
+    store->count += count;
+
+    /* totals and id index are built again (when needed) */
+    store->totaled = 0;
+
+    if (store->indexed) {
+        freeIdIndex(&store->id_index);
+        store->indexed = 0;
+    }
+
+    return 0;
+}
+
+
+/*
+ * Function to remove the record present in the given position
+ * leaf is released, when its last record is removed
+ */
+int removeStoreRecord(RecordStore *store, const StorePos *pos)
+{
+    StoreLeaf *leaf;
+    int index;
+
+    if (store == NULL || pos == NULL || pos->leaf == NULL
+            || pos->index < 0 || pos->index >= pos->leaf->count) {
+        logError(ERROR_FUNC_ARG);
+        return -2;
+    }
+
+    leaf    = pos->leaf;
+    index   = pos->index;
+
+    /* last record of the leaf, no need to copy the leaf */
+    if (leaf->count > 1 && ownLeaf(store, leaf) != 0)
+        return -1;
+
+    if (store->indexed)
+        removeIdIndex(&store->id_index, leaf->id[index]);
+
+    updateTotals(store, leaf, index, -1);
+
+    moveLeafRecords(leaf, index, leaf, index + 1, leaf->count - index - 1);
+    leaf->count--;
+    store->count--;
+
+    if (leaf->count == 0) {
+        unlinkLeaf(store, leaf);
+        removeChild(store, leaf->parent, childIndex(leaf->parent, leaf));
+        freeLeaf(store, leaf);
+    }
+
+    return 0;
+}
+
+
+/*
+ * Function to find the position of the record with the given id
+ * index is built on the first call, and maintained after that
+ *
+ * Return = 0, indicates record found
+ * Return > 0, indicates no record found
+ * Return < 0, indicates error
+ */
+int findStoreRecord(RecordStore *store, int record_id, StorePos *pos)
+{
+    StoreLeaf *leaf;
+    int index;
+
+    if (store == NULL || pos == NULL)
+        return -2;
+
+    if (store->indexed == 0) {
+        for (leaf = store->head; leaf != NULL; leaf = leaf->next) {
+            if (indexLeaf(store, leaf, 0) != 0) {
+                freeIdIndex(&store->id_index);
+                return -1;
+            }
+        }
+
+        store->indexed = 1;
+    }
+
+    leaf = getIdIndex(&store->id_index, record_id);
+    if (leaf == NULL)
+        return 1;
+
+    /* id column of a single leaf is short and contiguous */
+    for (index = 0; index < leaf->count; index++) {
+        if (leaf->id[index] == record_id) {
+            pos->leaf   = leaf;
+            pos->index  = index;
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+
+/*
+ * Function to copy the record in the given position into rec
+ */
+int getStoreRecord(const StorePos *pos, Record *rec)
+{
+    const StoreLeaf *leaf;
+    int index;
+
+    if (pos == NULL || pos->leaf == NULL || rec == NULL)
+        return -1;
+
+    leaf    = pos->leaf;
+    index   = pos->index;
+
+    if (index < 0 || index >= leaf->count)
+        return -1;
+
+    rec->r_id       = leaf->id[index];
+    rec->r_info     = leaf->info[index];
+    rec->r_date     = keyToDate(leaf->date_key[index]);
+    rec->r_amount   = leaf->amount[index];
+    memcpy(rec->r_entity, leaf->entity[index], ENTITY_LEN);
+    memcpy(rec->r_comment, leaf->comment[index], COMMENT_LEN);
+
+    return 0;
+}
+
+
+/*
+ * Function to overwrite the record in the given position with rec
+ * Note: caller should take care of the date order, if date is changed
+ */
+int setStoreRecord(RecordStore *store, const StorePos *pos, const Record *rec)
+{
+    if (store == NULL || pos == NULL || pos->leaf == NULL || rec == NULL)
+        return -1;
+
+    if (pos->index < 0 || pos->index >= pos->leaf->count)
+        return -1;
+
+    if (ownLeaf(store, pos->leaf) != 0)
+        return -1;
+
+    updateTotals(store, pos->leaf, pos->index, -1);
+    writeLeafRecord(pos->leaf, pos->index, rec);
+    updateTotals(store, pos->leaf, pos->index, 1);
+
+    return 0;
+}
+
+
+/*
+ * Function to get the position of the latest record
+ *
+ * Return = 0, indicates success
+ * Return > 0, indicates no records
+ */
+int lastStorePos(const RecordStore *store, StorePos *pos)
+{
+    if (store == NULL || pos == NULL || store->tail == NULL)
+        return 1;
+
+    pos->leaf   = store->tail;
+    pos->index  = store->tail->count - 1;
+
+    return 0;
+}
+
+
+/*
+ * Function to get the position of the latest record,
+ * whose date is same or older than the given date
+ *
+ * Return = 0, indicates success
+ * Return > 0, indicates no such records
+ */
+int seekStoreDate(const RecordStore *store, DateKey key, StorePos *pos)
+{
+    StoreLeaf *leaf;
+    int index;
+
+    if (store == NULL || pos == NULL || store->root == NULL)
+        return 1;
+
+    leaf    = descendStore(store, key);
+    index   = upperBoundLeaf(leaf, key);
+
+    pos->leaf   = leaf;
+    pos->index  = index;
+
+    if (index > 0) {
+        pos->index--;
+        return 0;
+    }
+
+    return prevStorePos(pos);
+}
+
+
+/*
+ * Function to move the position into the previous (older) record
+ *
+ * Return = 0, indicates success
+ * Return > 0, indicates no more records
+ */
+int prevStorePos(StorePos *pos)
+{
+    if (pos == NULL || pos->leaf == NULL)
+        return 1;
+
+    if (pos->index > 0) {
+        pos->index--;
+        return 0;
+    }
+
+    pos->leaf = pos->leaf->prev;
+
+    if (pos->leaf == NULL)
+        return 1;
+
+    pos->index = pos->leaf->count - 1;
+
+    return 0;
+}
+
+
+/*
+ * Function to move the position into the next (newer) record
+ *
+ * Return = 0, indicates success
+ * Return > 0, indicates no more records
+ */
+int nextStorePos(StorePos *pos)
+{
+    if (pos == NULL || pos->leaf == NULL)
+        return 1;
+
+    if (pos->index < pos->leaf->count - 1) {
+        pos->index++;
+        return 0;
+    }
+
+    pos->leaf = pos->leaf->next;
+
+    if (pos->leaf == NULL)
+        return 1;
+
+    pos->index = 0;
+
+    return 0;
+}
+
+
+/*
+ * Function to get the totals of the records within the date range 
+ * (both inclusive), without visiting the records of the range
+ * totals are built on the first call, and maintained after that
+ *
+ * Return = 0, indicates success
+ * Return < 0, indicates error
+ */
+int rangeStoreTotals(RecordStore *store, DateKey min, DateKey max,
+        StoreTotals *totals)
+{
+    StoreTotals older;
+
+    if (store == NULL || totals == NULL) {
+        logError(ERROR_FUNC_ARG);
+        return -2;
+    }
+
+    if (store->totaled == 0) {
+        buildStoreTotals(store);
+        store->totaled = 1;
+    }
+
+    memset(totals, 0, sizeof(*totals));
+
+    if (min > max)
+        return 0;
+
+    prefixTotals(store, max, totals);
+    prefixTotals(store, min - 1, &older);
+    addTotals(totals, &older, -1);
+
+    return 0;
+}
+
+
+/*
+ * Function to return the size of the columns in file for given no of records
+ */
+size_t recordStoreFileSize(int count)
+{
+    size_t offset[NO_OF_COLUMN + 1];
+
+    if (count < 0)
+        return 0;
+
+    columnOffsets(count, column_width, offset);
+
+    return offset[NO_OF_COLUMN];
+}
+
+
+/*
+ * Function to point the leaves of the store directly into the mapping
+ * store takes the ownership of the mapping
+ *
+ * records are not read or copied, but a leaf header is created for every
+ * LEAF_CAPACITY records and the inner nodes are built above them,
+ * so the time is linear in the no of leaves (count / LEAF_CAPACITY)
+ *
+ * offset - start of the columns within the mapping
+ */
+int attachRecordStore(RecordStore *store, void *map_base, size_t map_length,
+        size_t offset, int count)
+{
+    size_t column[NO_OF_COLUMN + 1];
+    StoreLeaf *leaf;
+    char *base;
+    int start;
+
+    if (store == NULL || map_base == NULL || count < 0) {
+        logError(ERROR_FUNC_ARG);
+        return -2;
+    }
+
+    if (offset + recordStoreFileSize(count) > map_length) {
+        logError(ERROR_FILE_READ);
+        return -1;
+    }
+
+    freeRecordStore(store);
+    columnOffsets(count, column_width, column);
+
+    base = (char *) map_base + offset;
+
+    /* only the leaves are created, records are not touched */
+    for (start = 0; start < count; start += LEAF_CAPACITY) {
+        leaf = allocSlab(&store->leaf_slab);
+        if (leaf == NULL) {
+            freeRecordStore(store);
+            return -1;
+        }
+
+        memset(leaf, 0, sizeof(*leaf));
+
+        leaf->id        = (int *) (base + column[0]) + start;
+        leaf->info      = (int *) (base + column[1]) + start;
+        leaf->date_key  = (DateKey *) (base + column[2]) + start;
+        leaf->amount    = (long *) (base + column[3]) + start;
+        leaf->entity    = (char (*)[ENTITY_LEN]) (base + column[4]) + start;
+        leaf->comment   = (char (*)[COMMENT_LEN]) (base + column[5]) + start;
+        leaf->count     = (count - start < LEAF_CAPACITY) ? count - start : LEAF_CAPACITY;
+        leaf->block     = NULL;
+
+        linkLeafAfter(store, store->tail, leaf);
+    }
+
+    store->count        = count;
+    store->map_base     = map_base;
+    store->map_length   = map_length;
+
+    if (buildStoreNodes(store) != 0) {
+        /* mapping is released by the caller */
+        store->map_base = NULL;
+        freeRecordStore(store);
+        return -1;
+    }
+
+    return 0;
+}
+
+
+/*
+ * Function to read the columns of given no of records from file
+ */
+int readRecordStore(RecordStore *store, FILE *fp, int count)
+{
+    size_t column[NO_OF_COLUMN + 1];
+    StoreLeaf *leaf;
+    void *data;
+    size_t width;
+    long start;
+    int index, remaining;
+
+    if (store == NULL || fp == NULL || count < 0) {
+        logError(ERROR_FUNC_ARG);
+        return -2;
+    }
+
+    freeRecordStore(store);
+
+    for (remaining = count; remaining > 0; remaining -= leaf->count) {
+        leaf = createLeaf(store);
+        if (leaf == NULL) {
+            freeRecordStore(store);
+            return -1;
+        }
+
+        leaf->count = (remaining < LEAF_CAPACITY) ? remaining : LEAF_CAPACITY;
+        linkLeafAfter(store, store->tail, leaf);
+    }
+
+    store->count = count;
+
+    columnOffsets(count, column_width, column);
+    start = ftell(fp);
+
+    for (index = 0; index < NO_OF_COLUMN; index++) {
+        if (fseek(fp, start + column[index], SEEK_SET) != 0) {
+            logError(ERROR_FILE_READ);
+            freeRecordStore(store);
+            return -1;
+        }
+
+        for (leaf = store->head; leaf != NULL; leaf = leaf->next) {
+            data = leafColumn(leaf, index, &width);
+
+            if (fread(data, width, leaf->count, fp) != (size_t) leaf->count) {
+                logError(ERROR_FILE_READ);
+                freeRecordStore(store);
+                return -1;
+            }
+        }
+    }
+
+    if (buildStoreNodes(store) != 0) {
+        freeRecordStore(store);
+        return -1;
+    }
+
+    return 0;
+}
+
+
+/*
+ * Function to load the columns of the previous file format (v2) into store
+ * records are copied into the leaves, date is converted into date key
+ *
+ * columns - start of the columns (in memory)
+ */
+int loadRecordStoreV2(RecordStore *store, const void *columns, size_t length,
+        int count)
+{
+    size_t column[NO_OF_COLUMN + 1];
+    const char *base = columns;
+    const Date *date;
+    StoreLeaf *leaf;
+    int start, index;
+
+    if (store == NULL || columns == NULL || count < 0) {
+        logError(ERROR_FUNC_ARG);
+        return -2;
+    }
+
+    columnOffsets(count, v2_column_width, column);
+
+    if (column[NO_OF_COLUMN] > length) {
+        logError(ERROR_FILE_READ);
+        return -1;
+    }
+
+    freeRecordStore(store);
+
+    for (start = 0; start < count; start += leaf->count) {
+        leaf = createLeaf(store);
+        if (leaf == NULL) {
+            freeRecordStore(store);
+            return -1;
+        }
+
+        leaf->count = (count - start < LEAF_CAPACITY) ? count - start : LEAF_CAPACITY;
+        linkLeafAfter(store, store->tail, leaf);
+
+        memcpy(leaf->id, (const int *) (base + column[0]) + start,
+            leaf->count * sizeof(*leaf->id));
+        memcpy(leaf->info, (const int *) (base + column[1]) + start,
+            leaf->count * sizeof(*leaf->info));
+        memcpy(leaf->amount, (const long *) (base + column[3]) + start,
+            leaf->count * sizeof(*leaf->amount));
+        memcpy(leaf->entity, (const char (*)[ENTITY_LEN]) (base + column[4]) + start,
+            leaf->count * sizeof(*leaf->entity));
+        memcpy(leaf->comment, (const char (*)[COMMENT_LEN]) (base + column[5]) + start,
+            leaf->count * sizeof(*leaf->comment));
+
+        date = (const Date *) (base + column[2]) + start;
+
+        for (index = 0; index < leaf->count; index++)
+            leaf->date_key[index] = DATE_KEY(date[index]);
+    }
+
+    store->count = count;
+
+    if (buildStoreNodes(store) != 0) {
+        freeRecordStore(store);
+        return -1;
+    }
+
+    return 0;
+}
+
+
+/*
+ * Function to write all the columns of the store into file
+ */
+int writeRecordStore(const RecordStore *store, FILE *fp)
+{
+    if (store == NULL || fp == NULL) {
+        logError(ERROR_FUNC_ARG);
+        return -2;
+    }
+
+    return writeLeafList(store->head, store->count, fp);
+}
+
+
+/*
+ * Function to start reading the columns of a store file (fp should be at
+ * the start of the columns) from the latest record not after max_key,
+ * which is found by a binary search on the date column
+ *
+ * Return = 0, indicates success
+ * Return < 0, indicates error
+ */
+int openStoreStream(StoreStream *stream, FILE *fp, int count, DateKey max_key)
+{
+    size_t column[NO_OF_COLUMN + 1];
+    DateKey key;
+    int low, high, mid;
+
+    if (stream == NULL || fp == NULL || count < 0) {
+        logError(ERROR_FUNC_ARG);
+        return -2;
+    }
+
+    memset(stream, 0, sizeof(*stream));
+
+    stream->fp      = fp;
+    stream->start   = ftell(fp);
+    stream->count   = count;
+
+    if (stream->start < 0) {
+        logError(ERROR_FILE_READ);
+        return -1;
+    }
+
+    stream->block = malloc(STREAM_CHUNK * (LEAF_BLOCK_SIZE / LEAF_CAPACITY));
+    if (stream->block == NULL) {
+        logError(ERROR_MEMORY_ALLOC);
+        return -1;
+    }
+
+    carveLeafColumns(&stream->chunk, stream->block, STREAM_CHUNK);
+
+    /* no of records not after max_key (dates are sorted within column) */
+    columnOffsets(count, column_width, column);
+
+    low     = 0;
+    high    = count;
+
+    while (low < high) {
+        mid = low + (high - low) / 2;
+
+        if (fseek(fp, stream->start + column[2] + mid * sizeof(key), SEEK_SET) != 0
+                || fread(&key, sizeof(key), 1, fp) != 1) {
+            logError(ERROR_FILE_READ);
+            closeStoreStream(stream);
+            return -1;
+        }
+
+        if (key <= max_key)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    stream->remaining = low;
+
+    return 0;
+}
+
+
+/*
+ * Function to read the chunk of records just older than the last chunk
+ * (records of the chunk are from the oldest, same as a leaf)
+ *
+ * Return = 0, indicates success
+ * Return > 0, indicates no more records
+ * Return < 0, indicates error
+ */
+int readStoreStream(StoreStream *stream)
+{
+    size_t column[NO_OF_COLUMN + 1];
+    size_t width;
+    void *data;
+    int index, from;
+
+    if (stream == NULL || stream->block == NULL) {
+        logError(ERROR_FUNC_ARG);
+        return -2;
+    }
+
+    if (stream->remaining == 0)
+        return 1;
+
+    stream->chunk.count = (stream->remaining < STREAM_CHUNK) 
+        ? stream->remaining : STREAM_CHUNK;
+
+    from = stream->remaining - stream->chunk.count;
+
+    columnOffsets(stream->count, column_width, column);
+
+    for (index = 0; index < NO_OF_COLUMN; index++) {
+        data = leafColumn(&stream->chunk, index, &width);
+
+        if (fseek(stream->fp, stream->start + column[index] + from * width,
+                    SEEK_SET) != 0
+                || fread(data, width, stream->chunk.count, stream->fp) 
+                    != (size_t) stream->chunk.count) {
+            logError(ERROR_FILE_READ);
+            return -1;
+        }
+    }
+
+    stream->remaining = from;
+
+    return 0;
+}
+
+
+/*
+ * To free the chunk of the stream (file is not closed)
+ */
+void closeStoreStream(StoreStream *stream)
+{
+    if (stream == NULL)
+        return;
+
+    free(stream->block);
+    stream->block = NULL;
+}
+
+
+/*
+ * Function to take a snapshot of the store
+ * only the leaves are copied, columns are shared until they are modified
+ *
+ * Return = 0, indicates success
+ * Return > 0, indicates a snapshot is already active
+ * Return < 0, indicates error
+ */
+int snapshotRecordStore(RecordStore *store, StoreSnapshot *snapshot)
+{
+    StoreLeaf *leaf;
+    int index = 0;
+
+    if (store == NULL || snapshot == NULL) {
+        logError(ERROR_FUNC_ARG);
+        return -2;
+    }
+
+    if (store->snapshot_active)
+        return 1;
+
+    memset(snapshot, 0, sizeof(*snapshot));
+
+    for (leaf = store->head; leaf != NULL; leaf = leaf->next)
+        snapshot->no_of_leaf++;
+
+    if (snapshot->no_of_leaf > 0) {
+        snapshot->leaf = malloc(snapshot->no_of_leaf * sizeof(*snapshot->leaf));
+        if (snapshot->leaf == NULL) {
+            logError(ERROR_MEMORY_ALLOC);
+            return -1;
+        }
+    }
+
+    for (leaf = store->head; leaf != NULL; leaf = leaf->next, index++) {
+        snapshot->leaf[index]       = *leaf;
+        snapshot->leaf[index].prev  = NULL;
+        snapshot->leaf[index].next  = (leaf->next != NULL) 
+            ? &snapshot->leaf[index + 1] : NULL;
+    }
+
+    snapshot->count = store->count;
+
+    /* every existing leaf is shared from now */
+    store->epoch++;
+    store->snapshot_active = 1;
+
+    return 0;
+}
+
+
+/*
+ * Function to write all the columns of the snapshot into file
+ * Note: can be called from another thread, while the store is modified
+ */
+int writeStoreSnapshot(const StoreSnapshot *snapshot, FILE *fp)
+{
+    if (snapshot == NULL || fp == NULL) {
+        logError(ERROR_FUNC_ARG);
+        return -2;
+    }
+
+    return writeLeafList(snapshot->leaf, snapshot->count, fp);
+}
+
+
+/*
+ * Function to release the snapshot, and free the blocks retired for it
+ * Note: snapshot should not be in use anymore
+ */
+void releaseStoreSnapshot(RecordStore *store, StoreSnapshot *snapshot)
+{
+    if (store == NULL || snapshot == NULL)
+        return;
+
+    while (store->retired_count > 0)
+        freeSlab(&store->block_slab, store->retired[--store->retired_count]);
+
+    free(snapshot->leaf);
+    memset(snapshot, 0, sizeof(*snapshot));
+
+    store->snapshot_active = 0;
+}
+
+
+/*
+ * Function to create an empty leaf with its own memory for columns
+ */
+static StoreLeaf *createLeaf(RecordStore *store)
+{
+    StoreLeaf *leaf = allocSlab(&store->leaf_slab);
+
+    if (leaf == NULL)
+        return NULL;
+
+    memset(leaf, 0, sizeof(*leaf));
+
+    leaf->block = allocSlab(&store->block_slab);
+    if (leaf->block == NULL) {
+        freeSlab(&store->leaf_slab, leaf);
+        return NULL;
+    }
+
+    carveLeafColumns(leaf, leaf->block, LEAF_CAPACITY);
+    leaf->epoch = store->epoch;
+
+    return leaf;
+}
+
+
+/*
+ * Function to copy the columns of a leaf into its own memory, 
+ * before the leaf is modified, if the columns are pointing into 
+ * the mapping or shared with the active snapshot
+ */
+static int ownLeaf(RecordStore *store, StoreLeaf *leaf)
+{
+    StoreLeaf temp;
+    void *block;
+
+    if (leaf->block != NULL && isSharedLeaf(store, leaf) == 0)
+        return 0;
+
+    temp = *leaf;
+
+    block = allocSlab(&store->block_slab);
+    if (block == NULL)
+        return -1;
+
+    /* old block is still in use by the snapshot */
+    if (leaf->block != NULL && retireBlock(store, leaf->block) != 0) {
+        freeSlab(&store->block_slab, block);
+        return -1;
+    }
+
+    leaf->block = block;
+    leaf->epoch = store->epoch;
+
+    carveLeafColumns(leaf, leaf->block, LEAF_CAPACITY);
+    moveLeafRecords(leaf, 0, &temp, 0, leaf->count);
+
+    return 0;
+}
+
+
+/*
+ * To give back the leaf and its memory (if not in the mapping) into slab
+ * memory shared with the snapshot is retired instead
+ */
+static void freeLeaf(RecordStore *store, StoreLeaf *leaf)
+{
+    if (leaf == NULL)
+        return;
+
+    if (leaf->block != NULL && isSharedLeaf(store, leaf)) {
+        /* if not retired, it is freed along with the slab */
+        retireBlock(store, leaf->block);
+    } else {
+        freeSlab(&store->block_slab, leaf->block);
+    }
+
+    freeSlab(&store->leaf_slab, leaf);
+}
+
+
+/*
+ * return value of non-zero, indicates the block of leaf is in snapshot
+ */
+static int isSharedLeaf(const RecordStore *store, const StoreLeaf *leaf)
+{
+    return store->snapshot_active && leaf->epoch < store->epoch;
+}
+
+
+/*
+ * Function to keep the block (in use by the snapshot) until it is released
+ */
+static int retireBlock(RecordStore *store, void *block)
+{
+    void **retired;
+    int capacity;
+
+    if (store->retired_count == store->retired_capacity) {
+        capacity = (store->retired_capacity > 0) ? store->retired_capacity * 2 : 16;
+
+        retired = realloc(store->retired, capacity * sizeof(*retired));
+        if (retired == NULL) {
+            logError(ERROR_MEMORY_ALLOC);
+            return -1;
+        }
+
+        store->retired          = retired;
+        store->retired_capacity = capacity;
+    }
+
+    store->retired[store->retired_count++] = block;
+
+    return 0;
+}
+
+
+/*
+ * Function to point the columns of the leaf into the block
+ * 8 byte columns first, so that every column is aligned
+ */
+static void carveLeafColumns(StoreLeaf *leaf, char *block, int capacity)
+{
+    leaf->amount    = (long *) block;
+    block          += capacity * sizeof(*leaf->amount);
+    leaf->id        = (int *) block;
+    block          += capacity * sizeof(*leaf->id);
+    leaf->info      = (int *) block;
+    block          += capacity * sizeof(*leaf->info);
+    leaf->date_key  = (DateKey *) block;
+    block          += capacity * sizeof(*leaf->date_key);
+    leaf->entity    = (char (*)[ENTITY_LEN]) block;
+    block          += capacity * sizeof(*leaf->entity);
+    leaf->comment   = (char (*)[COMMENT_LEN]) block;
+}
+
+
+/*
+ * Function to move the records (all columns) within a leaf or between leaves
+ */
+static void moveLeafRecords(StoreLeaf *dest, int dest_index,
+        const StoreLeaf *src, int src_index, int count)
+{
+    if (count <= 0)
+        return;
+
+    memmove(&dest->id[dest_index], &src->id[src_index], count * sizeof(*dest->id));
+    memmove(&dest->info[dest_index], &src->info[src_index], count * sizeof(*dest->info));
+    memmove(&dest->date_key[dest_index], &src->date_key[src_index], count * sizeof(*dest->date_key));
+    memmove(&dest->amount[dest_index], &src->amount[src_index], count * sizeof(*dest->amount));
+    memmove(&dest->entity[dest_index], &src->entity[src_index], count * sizeof(*dest->entity));
+    memmove(&dest->comment[dest_index], &src->comment[src_index], count * sizeof(*dest->comment));
+}
+
+
+/*
+ * Function to write the record into the given index of the leaf
+ */
+static void writeLeafRecord(StoreLeaf *leaf, int index, const Record *rec)
+{
+    leaf->id[index]     = rec->r_id;
+    leaf->info[index]   = rec->r_info;
+    leaf->date_key[index] = DATE_KEY(rec->r_date);
+    leaf->amount[index] = rec->r_amount;
+    memcpy(leaf->entity[index], rec->r_entity, ENTITY_LEN);
+    memcpy(leaf->comment[index], rec->r_comment, COMMENT_LEN);
+}
+
+
+/*
+ * Function to merge the records from src leaf (to the latest) and 
+ * the batch into new full leaves, linked only among themselves
+ * runs of the existing records are moved together
+ *
+ * Return the oldest of the new leaves, NULL on error
+ */
+static StoreLeaf *mergeLeaves(RecordStore *store, const StoreLeaf *src,
+        const Record **batch, int count)
+{
+    StoreLeaf *first = NULL;
+    StoreLeaf *last = NULL;
+    StoreLeaf *leaf;
+    DateKey key;
+    int index = 0;
+    int src_index = 0;
+    int run;
+
+    while (index < count || src != NULL) {
+        if (last == NULL || last->count == LEAF_CAPACITY) {
+            leaf = createLeaf(store);
+
+            if (leaf == NULL) {
+                for (; first != NULL; first = leaf) {
+                    leaf = first->next;
+                    freeLeaf(store, first);
+                }
+
+                return NULL;
+            }
+
+            leaf->prev = last;
+
+            if (last != NULL) {
+                last->next = leaf;
+            } else {
+                first = leaf;
+            }
+
+            last = leaf;
+        }
+
+        key = (index < count) ? DATE_KEY(batch[index]->r_date) : INT_MAX;
+
+        if (src == NULL || (src_index < src->count && src->date_key[src_index] > key)) {
+            writeLeafRecord(last, last->count++, batch[index++]);
+            continue;
+        }
+
+        /* existing records not after the batch record, as many as fit */
+        run = src_index;
+
+        while (run < src->count && src->date_key[run] <= key
+                && run - src_index < LEAF_CAPACITY - last->count)
+            run++;
+
+        moveLeafRecords(last, last->count, src, src_index, run - src_index);
+        last->count += run - src_index;
+        src_index = run;
+
+        if (src_index == src->count) {
+            src         = src->next;
+            src_index   = 0;
+        }
+    }
+
+    return first;
+}
+
+
+/*
+ * Function to split the full leaf into two, before inserting a record
+ * pos is updated with the leaf and index where the record should go
+ *
+ * when a record is added after the latest record,
+ * an empty leaf is started instead of splitting into half
+ */
+static int splitLeaf(RecordStore *store, StoreLeaf *leaf, DateKey key,
+        StorePos *pos)
+{
+    StoreLeaf *sibling;
+    int half;
+
+    if (leaf == store->tail && pos->index == leaf->count) {
+        half = leaf->count;
+    } else {
+        half = LEAF_CAPACITY / 2;
+    }
+
+    sibling = createLeaf(store);
+    if (sibling == NULL)
+        return -1;
+
+    moveLeafRecords(sibling, 0, leaf, half, leaf->count - half);
+    sibling->count = leaf->count - half;
+
+    if (insertChild(store, leaf->parent, childIndex(leaf->parent, leaf) + 1,
+            sibling, (sibling->count > 0) ? sibling->date_key[0] : key) != 0) {
+        freeLeaf(store, sibling);
+        return -1;
+    }
+
+    leaf->count = half;
+    linkLeafAfter(store, leaf, sibling);
+
+    /* nodes may be split too, so the totals of both paths are summed again */
+    if (store->totaled) {
+        sumLeafTotals(sibling, 0, sibling->count, &sibling->total);
+        addTotals(&leaf->total, &sibling->total, -1);
+        refreshTotals(sibling->parent);
+        refreshTotals(leaf->parent);
+    }
+
+    /* leaf is already split, index is built again on the next lookup */
+    if (store->indexed && indexLeaf(store, sibling, 0) != 0) {
+        freeIdIndex(&store->id_index);
+        store->indexed = 0;
+    }
+
+    /* record at the split point stays in the older leaf */
+    if (pos->index > half || sibling->count == 0) {
+        pos->leaf   = sibling;
+        pos->index -= half;
+    }
+
+    return 0;
+}
+
+
+/*
+ * To link the leaf into the list after the given leaf (NULL for head)
+ */
+static void linkLeafAfter(RecordStore *store, StoreLeaf *leaf, StoreLeaf *next)
+{
+    next->prev = leaf;
+
+    if (leaf == NULL) {
+        next->next  = store->head;
+        store->head = next;
+    } else {
+        next->next  = leaf->next;
+        leaf->next  = next;
+    }
+
+    if (next->next != NULL) {
+        next->next->prev = next;
+    } else {
+        store->tail = next;
+    }
+}
+
+
+/*
+ * To unlink the leaf from the list
+ */
+static void unlinkLeaf(RecordStore *store, StoreLeaf *leaf)
+{
+    if (leaf->prev != NULL) {
+        leaf->prev->next = leaf->next;
+    } else {
+        store->head = leaf->next;
+    }
+
+    if (leaf->next != NULL) {
+        leaf->next->prev = leaf->prev;
+    } else {
+        store->tail = leaf->prev;
+    }
+
+    leaf->prev = leaf->next = NULL;
+}
+
+
+/*
+ * Function to find the index just after the last record of the leaf
+ * whose date is same or older than the given date (binary search)
+ */
+static int upperBoundLeaf(const StoreLeaf *leaf, DateKey key)
+{
+    int low = 0;
+    int high = leaf->count;
+    int mid;
+
+    while (low < high) {
+        mid = low + (high - low) / 2;
+
+        if (leaf->date_key[mid] <= key) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    return low;
+}
+
+
+/*
+ * Function to find the leaf, where the record of given date should go
+ * at every level, the last child whose key is same or older than date
+ */
+static StoreLeaf *descendStore(const RecordStore *store, DateKey key)
+{
+    struct storeNode *node = store->root;
+    int low, high, mid;
+
+    while (node != NULL) {
+        /* key[0] is not compared, first child is taken by default */
+        low     = 1;
+        high    = node->count;
+
+        while (low < high) {
+            mid = low + (high - low) / 2;
+
+            if (node->key[mid] <= key) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+
+        if (node->leaf_level)
+            return node->child[low - 1];
+
+        node = node->child[low - 1];
+    }
+
+    return NULL;
+}
+
+
+/*
+ * Function to insert the child into the node at given index
+ * full node is split into two, and the new node is linked into the parent
+ */
+static int insertChild(RecordStore *store, struct storeNode *node, int index,
+        void *child, DateKey key)
+{
+    struct storeNode *sibling;
+    struct storeNode *root = NULL;
+    int half = NODE_CAPACITY / 2;
+    int i;
+
+    if (node->count == NODE_CAPACITY) {
+        sibling = createNode(store, node->leaf_level);
+        if (node->parent == NULL)
+            root = createNode(store, 0);
+
+        if (sibling == NULL || (node->parent == NULL && root == NULL)) {
+            freeSlab(&store->node_slab, sibling);
+            freeSlab(&store->node_slab, root);
+            return -1;
+        }
+
+        sibling->count      = node->count - half;
+        memcpy(sibling->key, &node->key[half], sibling->count * sizeof(*node->key));
+        memcpy(sibling->child, &node->child[half], sibling->count * sizeof(*node->child));
+
+        if (root != NULL) {
+            /* root is split, tree grows by one level */
+            root->count     = 1;
+            root->key[0]    = node->key[0];
+            root->child[0]  = node;
+            node->parent    = root;
+            store->root     = root;
+        }
+
+        if (insertChild(store, node->parent, childIndex(node->parent, node) + 1,
+                sibling, sibling->key[0]) != 0) {
+            freeSlab(&store->node_slab, sibling);
+            return -1;
+        }
+
+        node->count = half;
+
+        for (i = 0; i < sibling->count; i++)
+            setParent(sibling->child[i], sibling->leaf_level, sibling);
+
+        /* older node may not be in the path, which is summed after the split */
+        if (store->totaled) {
+            sumNodeTotals(node);
+            sumNodeTotals(sibling);
+        }
+
+        /* child at the split point stays in the older node */
+        if (index > half) {
+            node    = sibling;
+            index  -= half;
+        }
+    }
+
+    memmove(&node->key[index + 1], &node->key[index],
+        (node->count - index) * sizeof(*node->key));
+    memmove(&node->child[index + 1], &node->child[index],
+        (node->count - index) * sizeof(*node->child));
+
+    node->key[index]    = key;
+    node->child[index]  = child;
+    node->count++;
+
+    setParent(child, node->leaf_level, node);
+
+    return 0;
+}
+
+
+/*
+ * Function to remove the child from the node
+ * empty node is removed from its parent too
+ */
+static void removeChild(RecordStore *store, struct storeNode *node, int index)
+{
+    struct storeNode *child;
+
+    memmove(&node->key[index], &node->key[index + 1],
+        (node->count - index - 1) * sizeof(*node->key));
+    memmove(&node->child[index], &node->child[index + 1],
+        (node->count - index - 1) * sizeof(*node->child));
+
+    node->count--;
+
+    if (node->count == 0) {
+        if (node->parent != NULL) {
+            removeChild(store, node->parent, childIndex(node->parent, node));
+        } else {
+            store->root = NULL;
+        }
+
+        freeSlab(&store->node_slab, node);
+        return;
+    }
+
+    /* root with a single inner node, tree shrinks by one level */
+    if (node == store->root && node->count == 1 && node->leaf_level == 0) {
+        child           = node->child[0];
+        child->parent   = NULL;
+        store->root     = child;
+        freeSlab(&store->node_slab, node);
+    }
+}
+
+
+/*
+ * Function to create an empty node
+ */
+static struct storeNode *createNode(RecordStore *store, int leaf_level)
+{
+    struct storeNode *node = allocSlab(&store->node_slab);
+
+    if (node == NULL)
+        return NULL;
+
+    memset(node, 0, sizeof(*node));
+    node->leaf_level = leaf_level;
+
+    return node;
+}
+
+
+/*
+ * To find the index of the child within the node
+ */
+static int childIndex(const struct storeNode *node, const void *child)
+{
+    int index;
+
+    for (index = 0; index < node->count; index++) {
+        if (node->child[index] == child)
+            return index;
+    }
+
+    return -1;
+}
+
+
+static void setParent(void *child, int leaf_level, struct storeNode *parent)
+{
+    if (leaf_level) {
+        ((StoreLeaf *) child)->parent = parent;
+    } else {
+        ((struct storeNode *) child)->parent = parent;
+    }
+}
+
+
+static DateKey oldestKey(const void *child, int leaf_level)
+{
+    if (leaf_level)
+        return ((const StoreLeaf *) child)->date_key[0];
+
+    return ((const struct storeNode *) child)->key[0];
+}
+
+
+/*
+ * Function to build the inner nodes (bottom up) for the list of leaves
+ * all the nodes are created first, so that the leaves are not touched
+ * when the nodes cannot be created
+ */
+static int buildStoreNodes(RecordStore *store)
+{
+    struct storeNode *node = NULL;
+    StoreLeaf *leaf;
+    void **level, **nodes;
+    int count = 0;
+    int no_of_node = 0;
+    int leaf_level = 1;
+    int index, parent_count;
+
+    for (leaf = store->head; leaf != NULL; leaf = leaf->next)
+        count++;
+
+    if (count == 0)
+        return 0;
+
+    /* at least one level of node is needed above the leaves */
+    parent_count = count;
+    do {
+        parent_count = (parent_count + NODE_CAPACITY - 1) / NODE_CAPACITY;
+        no_of_node  += parent_count;
+    } while (parent_count > 1);
+
+    level = malloc((count + no_of_node) * sizeof(*level));
+    if (level == NULL) {
+        logError(ERROR_MEMORY_ALLOC);
+        return -1;
+    }
+
+    nodes = level + count;
+
+    for (index = 0; index < no_of_node; index++) {
+        nodes[index] = createNode(store, 0);
+
+        if (nodes[index] == NULL) {
+            while (index-- > 0)
+                freeSlab(&store->node_slab, nodes[index]);
+
+            free(level);
+            return -1;
+        }
+    }
+
+    count = 0;
+    for (leaf = store->head; leaf != NULL; leaf = leaf->next)
+        level[count++] = leaf;
+
+    do {
+        parent_count = 0;
+
+        for (index = 0; index < count; index++) {
+            if (index % NODE_CAPACITY == 0) {
+                node = *nodes++;
+                node->leaf_level = leaf_level;
+            }
+
+            node->key[node->count]      = oldestKey(level[index], leaf_level);
+            node->child[node->count]    = level[index];
+            node->count++;
+            setParent(level[index], leaf_level, node);
+
+            /* level array is reused for the parents */
+            if (index % NODE_CAPACITY == 0)
+                level[parent_count++] = node;
+        }
+
+        count       = parent_count;
+        leaf_level  = 0;
+    } while (count > 1);
+
+    store->root = level[0];
+    free(level);
+
+    return 0;
+}
+
+
+static void addTotals(StoreTotals *totals, const StoreTotals *add, int sign)
+{
+    totals->count   += sign * add->count;
+    totals->income  += sign * add->income;
+    totals->expense += sign * add->expense;
+}
+
+
+static void addRecordTotals(StoreTotals *totals, int info, long amount, int sign)
+{
+    totals->count += sign;
+
+    if (info & 1) {
+        totals->income += sign * amount;
+    } else {
+        totals->expense += sign * amount;
+    }
+}
+
+
+/*
+ * Function to add (sign 1) or remove (sign -1) the record in the given
+ * index into the totals of its leaf and all the nodes above it
+ */
+static void updateTotals(RecordStore *store, StoreLeaf *leaf, int index, int sign)
+{
+    struct storeNode *node;
+    int info    = leaf->info[index];
+    long amount = leaf->amount[index];
+
+    if (store->totaled == 0)
+        return;
+
+    addRecordTotals(&leaf->total, info, amount, sign);
+
+    for (node = leaf->parent; node != NULL; node = node->parent)
+        addRecordTotals(&node->total, info, amount, sign);
+}
+
+
+/*
+ * Function to sum the records of the leaf from index 'from' till 'to'
+ * info and amount columns alone are read (by the scan kernel)
+ */
+static void sumLeafTotals(const StoreLeaf *leaf, int from, int to, 
+        StoreTotals *totals)
+{
+    memset(totals, 0, sizeof(*totals));
+
+    totals->count = sumSelected(&leaf->amount[from], &leaf->info[from],
+        to - from, NULL, &totals->income, &totals->expense);
+}
+
+
+/*
+ * Function to sum the totals of the children (already summed) of the node
+ */
+static void sumNodeTotals(struct storeNode *node)
+{
+    const StoreTotals *child;
+    int index;
+
+    memset(&node->total, 0, sizeof(node->total));
+
+    for (index = 0; index < node->count; index++) {
+        if (node->leaf_level) {
+            child = &((const StoreLeaf *) node->child[index])->total;
+        } else {
+            child = &((const struct storeNode *) node->child[index])->total;
+        }
+
+        addTotals(&node->total, child, 1);
+    }
+}
+
+
+/*
+ * Function to sum the totals again, from the node till the root
+ */
+static void refreshTotals(struct storeNode *node)
+{
+    for (; node != NULL; node = node->parent)
+        sumNodeTotals(node);
+}
+
+
+/*
+ * Function to build the totals of all the leaves and nodes (bottom up)
+ */
+static void buildStoreTotals(RecordStore *store)
+{
+    struct storeNode *node;
+    StoreLeaf *leaf;
+    int index;
+
+    for (leaf = store->head; leaf != NULL; leaf = leaf->next)
+        sumLeafTotals(leaf, 0, leaf->count, &leaf->total);
+
+    /* every node is summed after all of its children (post order) */
+    node    = store->root;
+    index   = 0;
+
+    while (node != NULL) {
+        if (node->leaf_level == 0 && index < node->count) {
+            node    = node->child[index];
+            index   = 0;
+            continue;
+        }
+
+        sumNodeTotals(node);
+
+        if (node->parent != NULL)
+            index = childIndex(node->parent, node) + 1;
+
+        node = node->parent;
+    }
+}
+
+
+/*
+ * Function to get the totals of the records, whose date is same or
+ * older than the given date
+ * at every level, totals of the children older than the path are added,
+ * and within the leaf, the shorter side of the leaf is summed
+ */
+static void prefixTotals(const RecordStore *store, DateKey key, 
+        StoreTotals *totals)
+{
+    const struct storeNode *node = store->root;
+    const StoreTotals *child;
+    const StoreLeaf *leaf;
+    StoreTotals partial;
+    int low, high, mid, index;
+
+    memset(totals, 0, sizeof(*totals));
+
+    while (node != NULL) {
+        /* same as descendStore, last child whose key is same or older */
+        low     = 1;
+        high    = node->count;
+
+        while (low < high) {
+            mid = low + (high - low) / 2;
+
+            if (node->key[mid] <= key) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+
+        for (index = 0; index < low - 1; index++) {
+            if (node->leaf_level) {
+                child = &((const StoreLeaf *) node->child[index])->total;
+            } else {
+                child = &((const struct storeNode *) node->child[index])->total;
+            }
+
+            addTotals(totals, child, 1);
+        }
+
+        if (node->leaf_level)
+            break;
+
+        node = node->child[low - 1];
+    }
+
+    if (node == NULL)
+        return;
+
+    leaf    = node->child[low - 1];
+    index   = upperBoundLeaf(leaf, key);
+
+    if (index <= leaf->count / 2) {
+        sumLeafTotals(leaf, 0, index, &partial);
+        addTotals(totals, &partial, 1);
+    } else {
+        sumLeafTotals(leaf, index, leaf->count, &partial);
+        addTotals(totals, &leaf->total, 1);
+        addTotals(totals, &partial, -1);
+    }
+}
+
+
+/*
+ * Function to write the columns of the list of leaves into file
+ * every column is written from the oldest leaf to the latest leaf
+ */
+static int writeLeafList(const StoreLeaf *head, int count, FILE *fp)
+{
+    static const char padding[8];
+    size_t column[NO_OF_COLUMN + 1];
+    const StoreLeaf *leaf;
+    const void *data;
+    size_t written = 0;
+    size_t width = 0;
+    int index;
+
+    columnOffsets(count, column_width, column);
+
+    for (index = 0; index < NO_OF_COLUMN; index++) {
+        /* padding to align the start of the column */
+        if (column[index] > written) {
+            if (fwrite(padding, column[index] - written, 1, fp) != 1) {
+                logError(ERROR_FILE_WRITE);
+                return -1;
+            }
+        }
+
+        for (leaf = head; leaf != NULL; leaf = leaf->next) {
+            data = leafColumn(leaf, index, &width);
+
+            if (fwrite(data, width, leaf->count, fp) != (size_t) leaf->count) {
+                logError(ERROR_FILE_WRITE);
+                return -1;
+            }
+        }
+
+        leafColumn(head, index, &width);
+        written = column[index] + width * count;
+    }
+
+    return 0;
+}
+
+
+/*
+ * Function to calculate the start of every column (in file)
+ * offset[NO_OF_COLUMN] is the total size of all the columns
+ */
+static void columnOffsets(int count, const size_t *width, size_t *offset)
+{
+    size_t n = (size_t) count;
+    int index;
+
+    offset[0] = 0;
+
+    for (index = 0; index < NO_OF_COLUMN; index++)
+        offset[index + 1] = ALIGN_COLUMN(offset[index] + n * width[index]);
+}
+
+
+/*
+ * Function to return the column of the leaf (in file order) and its width
+ */
+static void *leafColumn(const StoreLeaf *leaf, int column, size_t *width)
+{
+    *width = column_width[column];
+
+    if (leaf == NULL)
+        return NULL;
+
+    switch (column) {
+        case 0:
+            return leaf->id;
+        case 1:
+            return leaf->info;
+        case 2:
+            return leaf->date_key;
+        case 3:
+            return leaf->amount;
+        case 4:
+            return leaf->entity;
+        default:
+            return leaf->comment;
+    }
+}
+
+
+/*
+ * Function to add the records of the leaf (from given index) into id index
+ */
+static int indexLeaf(RecordStore *store, StoreLeaf *leaf, int from)
+{
+    int index;
+
+    for (index = from; index < leaf->count; index++) {
+        if (putIdIndex(&store->id_index, leaf->id[index], leaf) != 0)
+            return -1;
+    }
+
+    return 0;
+}
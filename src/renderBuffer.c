@@ -0,0 +1,101 @@
+/*
+ * renderBuffer.c
+ *
+ * Output buffer for the record listings, whole pages of rows are
+ * formatted into one contiguous buffer and written with a single write
+ * instead of many small stdio calls for every row
+ *
+ *  Created on: 16-Oct-2026
+ *      Author: deepaks
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+
+#include "headers/renderBuffer.h"
+#include "headers/customError.h"
+
+
+static int reserveRender(int length);
+
+
+static char render_buffer[RENDER_BUFFER_SIZE];
+static int render_length = 0;
+
+
+/*
+ * To append the text of given length into render buffer
+ */
+void renderText(const char *text, int length)
+{
+    if (text == NULL || length <= 0)
+        return;
+
+    /* text larger than the buffer is written directly */
+    if (length > RENDER_BUFFER_SIZE) {
+        flushRender();
+        fwrite(text, 1, length, stdout);
+        fflush(stdout);
+        return;
+    }
+
+    reserveRender(length);
+
+    memcpy(render_buffer + render_length, text, length);
+    render_length += length;
+}
+
+
+/*
+ * Function to write the render buffer into stdout
+ * anything pending in the stdio buffer of stdout is written first
+ * so that the order of the output is kept
+ *
+ * Return = 0, indicates success
+ * Return < 0, indicates error (pending output is dropped)
+ */
+int flushRender()
+{
+    ssize_t written;
+    int offset = 0;
+
+    if (render_length == 0)
+        return 0;
+
+    fflush(stdout);
+
+    while (offset < render_length) {
+        written = write(STDOUT_FILENO, render_buffer + offset,
+            render_length - offset);
+
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+
+            logError(ERROR_FILE_WRITE);
+            render_length = 0;
+            return -1;
+        }
+
+        offset += (int) written;
+    }
+
+    render_length = 0;
+
+    return 0;
+}
+
+
+/*
+ * To make space for length characters in render buffer,
+ * buffer is flushed if it does not have the space
+ */
+static int reserveRender(int length)
+{
+    if (render_length + length <= RENDER_BUFFER_SIZE)
+        return 0;
+
+    return flushRender();
+}
@@ -0,0 +1,179 @@
+/*
+ * resultCache.c
+ *
+ * Cache of the recent scan results (matching records and totals),
+ * keyed by the compiled filter program, so that a repeated filter
+ * needs no scan till the records are changed
+ *
+ *  Created on: 16-Oct-2026
+ *      Author: deepaks
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "headers/resultCache.h"
+#include "headers/customError.h"
+
+
+static int isSameProgram(const FilterProgram *a, const FilterProgram *b);
+static void clearEntry(CachedResult *entry);
+
+
+/*
+ * To initialize an empty cache
+ */
+void initResultCache(ResultCache *cache)
+{
+    if (cache == NULL)
+        return;
+
+    memset(cache, 0, sizeof(*cache));
+}
+
+
+/*
+ * To free all the results of the cache
+ */
+void freeResultCache(ResultCache *cache)
+{
+    int index;
+
+    if (cache == NULL)
+        return;
+
+    for (index = 0; index < RESULT_CACHE_SIZE; index++)
+        clearEntry(&cache->entry[index]);
+
+    cache->tick = 0;
+}
+
+
+/*
+ * Function to find the result of the program, scanned at the generation
+ * (results of the older generations are freed, as they cannot be used)
+ *
+ * Return NULL, if result is not present
+ */
+const CachedResult *findResultCache(ResultCache *cache,
+        const FilterProgram *program, long generation)
+{
+    CachedResult *entry;
+    int index;
+
+    if (cache == NULL || program == NULL)
+        return NULL;
+
+    for (index = 0; index < RESULT_CACHE_SIZE; index++) {
+        entry = &cache->entry[index];
+
+        if (entry->used == 0)
+            continue;
+
+        if (entry->generation != generation) {
+            clearEntry(entry);
+            continue;
+        }
+
+        if (isSameProgram(&entry->program, program)) {
+            entry->used = ++cache->tick;
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+
+/*
+ * Function to add the result of the program into cache
+ * only the leaves having matching records are kept
+ *
+ * Return = 0, indicates success
+ * Return < 0, indicates error (result is not cached)
+ */
+int addResultCache(ResultCache *cache, const FilterProgram *program,
+        long generation, const StoreTotals *totals, const StoreLeaf **leaf,
+        uint64_t (*mask)[MASK_WORDS(LEAF_CAPACITY)], int count)
+{
+    CachedResult *entry;
+    int index, word, matched;
+
+    if (cache == NULL || program == NULL || totals == NULL || count < 0) {
+        logError(ERROR_FUNC_ARG);
+        return -2;
+    }
+
+    /* empty entry, otherwise the least recently used one */
+    entry = &cache->entry[0];
+
+    for (index = 1; index < RESULT_CACHE_SIZE && entry->used != 0; index++) {
+        if (cache->entry[index].used < entry->used)
+            entry = &cache->entry[index];
+    }
+
+    clearEntry(entry);
+
+    if (count > 0) {
+        entry->leaf = malloc(count * sizeof(*entry->leaf));
+        entry->mask = malloc(count * sizeof(*entry->mask));
+
+        if (entry->leaf == NULL || entry->mask == NULL) {
+            logError(ERROR_MEMORY_ALLOC);
+            clearEntry(entry);
+            return -1;
+        }
+    }
+
+    for (index = 0; index < count; index++) {
+        matched = 0;
+
+        for (word = 0; word < MASK_WORDS(leaf[index]->count); word++)
+            matched |= (mask[index][word] != 0);
+
+        if (matched == 0)
+            continue;
+
+        entry->leaf[entry->count] = leaf[index];
+        memcpy(entry->mask[entry->count], mask[index], sizeof(*entry->mask));
+        entry->count++;
+    }
+
+    entry->program      = *program;
+    entry->generation   = generation;
+    entry->totals       = *totals;
+    entry->used         = ++cache->tick;
+
+    return 0;
+}
+
+
+/*
+ * Function to compare the instructions of the programs
+ */
+static int isSameProgram(const FilterProgram *a, const FilterProgram *b)
+{
+    int index;
+
+    if (a->count != b->count || a->min_key != b->min_key
+            || a->max_key != b->max_key)
+        return 0;
+
+    for (index = 0; index < a->count; index++) {
+        if (a->op[index].op != b->op[index].op
+                || a->op[index].min != b->op[index].min
+                || a->op[index].max != b->op[index].max
+                || strcmp(a->op[index].text, b->op[index].text) != 0)
+            return 0;
+    }
+
+    return 1;
+}
+
+
+static void clearEntry(CachedResult *entry)
+{
+    free(entry->leaf);
+    free(entry->mask);
+    memset(entry, 0, sizeof(*entry));
+}
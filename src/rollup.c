@@ -0,0 +1,334 @@
+/*
+ * rollup.c
+ *
+ * Per month and per year totals of the records (rollups)
+ *
+ *  Created on: 16-Oct-2026
+ *      Author: deepaks
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "headers/rollup.h"
+#include "headers/customError.h"
+
+#define MIN_CAPACITY    16
+
+
+static int applyBucket(RollupList *list, int period, int info, long amount,
+        int sign);
+static int copyRollupList(RollupList *dest, const RollupList *src);
+static int loadRollupList(RollupList *list, const void *data, int count);
+
+
+/*
+ * To initialize the rollup without any buckets
+ */
+void initRollup(Rollup *rollup)
+{
+    if (rollup == NULL)
+        return;
+
+    memset(rollup, 0, sizeof(*rollup));
+}
+
+
+/*
+ * To free the buckets of the rollup
+ */
+void freeRollup(Rollup *rollup)
+{
+    if (rollup == NULL)
+        return;
+
+    free(rollup->month.bucket);
+    free(rollup->year.bucket);
+    initRollup(rollup);
+}
+
+
+/*
+ * Function to add (sign 1) or remove (sign -1) a record
+ * into the buckets of its month and year
+ *
+ * Return = 0, indicates success
+ * Return < 0, indicates error (rollup is marked as lost)
+ */
+int applyRollup(Rollup *rollup, DateKey key, int info, long amount, int sign)
+{
+    if (rollup == NULL) {
+        logError(ERROR_FUNC_ARG);
+        return -2;
+    }
+
+    if (applyBucket(&rollup->month, MONTH_PERIOD(key), info, amount, sign) != 0
+            || applyBucket(&rollup->year, KEY_YEAR(key), info, amount, sign) != 0) {
+        rollup->lost = 1;
+        return -1;
+    }
+
+    return 0;
+}
+
+
+/*
+ * Function to find the index of the first bucket,
+ * whose period is same or later than the given period (binary search)
+ */
+int findRollup(const RollupList *list, int period)
+{
+    int low = 0;
+    int high, mid;
+
+    if (list == NULL)
+        return 0;
+
+    high = list->count;
+
+    while (low < high) {
+        mid = low + (high - low) / 2;
+
+        if (list->bucket[mid].period < period) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    return low;
+}
+
+
+/*
+ * Function to copy the buckets of the rollup (dest should be initialized)
+ */
+int copyRollup(Rollup *dest, const Rollup *src)
+{
+    if (dest == NULL || src == NULL) {
+        logError(ERROR_FUNC_ARG);
+        return -2;
+    }
+
+    if (copyRollupList(&dest->month, &src->month) != 0
+            || copyRollupList(&dest->year, &src->year) != 0)
+        return -1;
+
+    dest->lost = src->lost;
+
+    return 0;
+}
+
+
+/*
+ * Function to write the rollup into file,
+ * no of month and year buckets, followed by the buckets
+ */
+int writeRollup(const Rollup *rollup, FILE *fp)
+{
+    int count[2];
+
+    if (rollup == NULL || fp == NULL) {
+        logError(ERROR_FUNC_ARG);
+        return -2;
+    }
+
+    count[0] = rollup->month.count;
+    count[1] = rollup->year.count;
+
+    if (fwrite(count, sizeof(count), 1, fp) != 1
+            || fwrite(rollup->month.bucket, sizeof(RollupBucket), count[0], fp)
+                != (size_t) count[0]
+            || fwrite(rollup->year.bucket, sizeof(RollupBucket), count[1], fp)
+                != (size_t) count[1]) {
+        logError(ERROR_FILE_WRITE);
+        return -1;
+    }
+
+    return 0;
+}
+
+
+/*
+ * Function to load the rollup written by writeRollup (from memory)
+ *
+ * Return = 0, indicates success
+ * Return > 0, indicates data is not a valid rollup
+ * Return < 0, indicates error
+ */
+int loadRollup(Rollup *rollup, const void *data, size_t length)
+{
+    const char *base = data;
+    int count[2];
+
+    if (rollup == NULL || data == NULL) {
+        logError(ERROR_FUNC_ARG);
+        return -2;
+    }
+
+    if (length < sizeof(count))
+        return 1;
+
+    memcpy(count, base, sizeof(count));
+
+    if (count[0] < 0 || count[1] < 0
+            || length - sizeof(count) < ((size_t) count[0] + count[1]) * sizeof(RollupBucket))
+        return 1;
+
+    freeRollup(rollup);
+
+    base += sizeof(count);
+
+    if (loadRollupList(&rollup->month, base, count[0]) != 0
+            || loadRollupList(&rollup->year, base + count[0] * sizeof(RollupBucket),
+                count[1]) != 0) {
+        freeRollup(rollup);
+        return -1;
+    }
+
+    return 0;
+}
+
+
+/*
+ * Function to read the rollup written by writeRollup (from file)
+ *
+ * Return = 0, indicates success
+ * Return > 0, indicates file does not have a valid rollup
+ * Return < 0, indicates error
+ */
+int readRollup(Rollup *rollup, FILE *fp)
+{
+    char *data;
+    int count[2];
+    size_t length;
+    int returnCode;
+
+    if (rollup == NULL || fp == NULL) {
+        logError(ERROR_FUNC_ARG);
+        return -2;
+    }
+
+    if (fread(count, sizeof(count), 1, fp) != 1 || count[0] < 0 || count[1] < 0)
+        return 1;
+
+    length = sizeof(count) + ((size_t) count[0] + count[1]) * sizeof(RollupBucket);
+
+    data = malloc(length);
+    if (data == NULL) {
+        logError(ERROR_MEMORY_ALLOC);
+        return -1;
+    }
+
+    memcpy(data, count, sizeof(count));
+
+    if (fread(data + sizeof(count), 1, length - sizeof(count), fp)
+            != length - sizeof(count)) {
+        free(data);
+        return 1;
+    }
+
+    returnCode = loadRollup(rollup, data, length);
+    free(data);
+
+    return returnCode;
+}
+
+
+/*
+ * Function to apply the record into the bucket of the period
+ * bucket is added for a new period, and removed when it has no records
+ */
+static int applyBucket(RollupList *list, int period, int info, long amount,
+        int sign)
+{
+    RollupBucket *bucket;
+    int index, capacity;
+
+    index = findRollup(list, period);
+
+    if (index == list->count || list->bucket[index].period != period) {
+        if (sign < 0)
+            return -1;
+
+        if (list->count == list->capacity) {
+            capacity = (list->capacity > 0) ? list->capacity * 2 : MIN_CAPACITY;
+
+            bucket = realloc(list->bucket, capacity * sizeof(*bucket));
+            if (bucket == NULL) {
+                logError(ERROR_MEMORY_ALLOC);
+                return -1;
+            }
+
+            list->bucket    = bucket;
+            list->capacity  = capacity;
+        }
+
+        memmove(&list->bucket[index + 1], &list->bucket[index],
+            (list->count - index) * sizeof(*list->bucket));
+        memset(&list->bucket[index], 0, sizeof(*list->bucket));
+
+        list->bucket[index].period = period;
+        list->count++;
+    }
+
+    bucket = &list->bucket[index];
+    bucket->count += sign;
+
+    if (info & 1) {
+        bucket->income += sign * amount;
+    } else {
+        bucket->expense += sign * amount;
+    }
+
+    if (bucket->count == 0) {
+        memmove(&list->bucket[index], &list->bucket[index + 1],
+            (list->count - index - 1) * sizeof(*list->bucket));
+        list->count--;
+    }
+
+    return 0;
+}
+
+
+static int copyRollupList(RollupList *dest, const RollupList *src)
+{
+    RollupBucket *bucket;
+
+    if (dest->capacity < src->count) {
+        bucket = realloc(dest->bucket, src->count * sizeof(*bucket));
+        if (bucket == NULL) {
+            logError(ERROR_MEMORY_ALLOC);
+            return -1;
+        }
+
+        dest->bucket    = bucket;
+        dest->capacity  = src->count;
+    }
+
+    if (src->count > 0)
+        memcpy(dest->bucket, src->bucket, src->count * sizeof(*bucket));
+
+    dest->count = src->count;
+
+    return 0;
+}
+
+
+static int loadRollupList(RollupList *list, const void *data, int count)
+{
+    if (count == 0)
+        return 0;
+
+    list->bucket = malloc(count * sizeof(*list->bucket));
+    if (list->bucket == NULL) {
+        logError(ERROR_MEMORY_ALLOC);
+        return -1;
+    }
+
+    memcpy(list->bucket, data, count * sizeof(*list->bucket));
+    list->count     = count;
+    list->capacity  = count;
+
+    return 0;
+}
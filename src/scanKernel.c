@@ -0,0 +1,580 @@
+/*
+ * scanKernel.c
+ *
+ * Kernels to select the records of a column within a range (as bitmask)
+ * and to sum the income and expense of the selected records,
+ * AVX2 or SSE4.2 version is chosen at runtime, scalar version otherwise
+ *
+ *  Created on: 16-Oct-2026
+ *      Author: deepaks
+ */
+
+#include <string.h>
+#include <pthread.h>
+
+#include "headers/scanKernel.h"
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define SCAN_KERNEL_X86
+#include <immintrin.h>
+#endif
+
+/* all the rows of a word are selected */
+#define ALL_ROWS    (~(uint64_t) 0)
+
+/*
+ * Set of kernels for an instruction set
+ */
+struct scanKernel {
+    const char  *name;
+    void        (*select_long)(const long *column, int count, long min,
+                    long max, uint64_t *mask);
+    void        (*select_int)(const int *column, int count, int min, int max,
+                    uint64_t *mask);
+    void        (*select_type)(const int *info, int count, int type,
+                    uint64_t *mask);
+    void        (*sum_selected)(const long *amount, const int *info, int count,
+                    const uint64_t *mask, long *income, long *expense);
+};
+
+
+static void chooseScanKernel(void);
+static int rowsOfWord(int count, int word);
+
+static void selectLongScalar(const long *column, int count, long min, long max,
+        uint64_t *mask);
+static void selectIntScalar(const int *column, int count, int min, int max,
+        uint64_t *mask);
+static void selectTypeScalar(const int *info, int count, int type,
+        uint64_t *mask);
+static void sumSelectedScalar(const long *amount, const int *info, int count,
+        const uint64_t *mask, long *income, long *expense);
+
+#ifdef SCAN_KERNEL_X86
+static void selectLongSse4(const long *column, int count, long min, long max,
+        uint64_t *mask);
+static void selectIntSse4(const int *column, int count, int min, int max,
+        uint64_t *mask);
+static void selectTypeSse4(const int *info, int count, int type,
+        uint64_t *mask);
+static void sumSelectedSse4(const long *amount, const int *info, int count,
+        const uint64_t *mask, long *income, long *expense);
+
+static void selectLongAvx2(const long *column, int count, long min, long max,
+        uint64_t *mask);
+static void selectIntAvx2(const int *column, int count, int min, int max,
+        uint64_t *mask);
+static void selectTypeAvx2(const int *info, int count, int type,
+        uint64_t *mask);
+static void sumSelectedAvx2(const long *amount, const int *info, int count,
+        const uint64_t *mask, long *income, long *expense);
+#endif
+
+
+static const struct scanKernel scalar_kernel = {
+    "scalar", selectLongScalar, selectIntScalar, selectTypeScalar,
+    sumSelectedScalar
+};
+
+#ifdef SCAN_KERNEL_X86
+static const struct scanKernel sse4_kernel = {
+    "sse4.2", selectLongSse4, selectIntSse4, selectTypeSse4, sumSelectedSse4
+};
+
+static const struct scanKernel avx2_kernel = {
+    "avx2", selectLongAvx2, selectIntAvx2, selectTypeAvx2, sumSelectedAvx2
+};
+#endif
+
+static const struct scanKernel *kernel = &scalar_kernel;
+static pthread_once_t kernel_once = PTHREAD_ONCE_INIT;
+
+
+/*
+ * Function to select the rows having value within [min, max]
+ * mask should have MASK_WORDS(count) words, bits after count are cleared
+ */
+void selectLongRange(const long *column, int count, long min, long max,
+        uint64_t *mask)
+{
+    if (column == NULL || mask == NULL || count <= 0)
+        return;
+
+    pthread_once(&kernel_once, chooseScanKernel);
+    kernel->select_long(column, count, min, max, mask);
+}
+
+
+/*
+ * Function to select the rows having value within [min, max] (int column)
+ */
+void selectIntRange(const int *column, int count, int min, int max,
+        uint64_t *mask)
+{
+    if (column == NULL || mask == NULL || count <= 0)
+        return;
+
+    pthread_once(&kernel_once, chooseScanKernel);
+    kernel->select_int(column, count, min, max, mask);
+}
+
+
+/*
+ * Function to select the rows of the type (1 - income, 0 - expense)
+ * from the info column
+ */
+void selectInfoType(const int *info, int count, int type, uint64_t *mask)
+{
+    if (info == NULL || mask == NULL || count <= 0)
+        return;
+
+    pthread_once(&kernel_once, chooseScanKernel);
+    kernel->select_type(info, count, type & 1, mask);
+}
+
+
+/*
+ * Function to add the amount of the selected rows into income or expense,
+ * without branching on the selection or the type of record
+ * all the rows are selected, if mask is NULL
+ *
+ * Return >= 0, indicates no of rows selected
+ */
+int sumSelected(const long *amount, const int *info, int count,
+        const uint64_t *mask, long *income, long *expense)
+{
+    long in_sum = 0;
+    long ex_sum = 0;
+    int selected = 0;
+    int word;
+
+    if (amount == NULL || info == NULL || count <= 0)
+        return 0;
+
+    pthread_once(&kernel_once, chooseScanKernel);
+    kernel->sum_selected(amount, info, count, mask, &in_sum, &ex_sum);
+
+    if (mask == NULL) {
+        selected = count;
+    } else {
+        for (word = 0; word < MASK_WORDS(count); word++)
+            selected += __builtin_popcountll(mask[word]);
+    }
+
+    if (income != NULL)
+        *income += in_sum;
+
+    if (expense != NULL)
+        *expense += ex_sum;
+
+    return selected;
+}
+
+
+/*
+ * Function to get the name of the kernels in use
+ */
+const char *scanKernelName(void)
+{
+    pthread_once(&kernel_once, chooseScanKernel);
+
+    return kernel->name;
+}
+
+
+static void chooseScanKernel(void)
+{
+#ifdef SCAN_KERNEL_X86
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2")) {
+        kernel = &avx2_kernel;
+        return;
+    }
+
+    if (__builtin_cpu_supports("sse4.2")) {
+        kernel = &sse4_kernel;
+        return;
+    }
+#endif
+
+    kernel = &scalar_kernel;
+}
+
+
+/*
+ * Function to get the no of rows in the word of mask
+ */
+static int rowsOfWord(int count, int word)
+{
+    int rows = count - word * MASK_BITS;
+
+    return (rows > MASK_BITS) ? MASK_BITS : rows;
+}
+
+
+/*
+ * scalar kernels, comparisons are turned into bits without branching
+ */
+static void selectLongScalar(const long *column, int count, long min, long max,
+        uint64_t *mask)
+{
+    int index;
+
+    memset(mask, 0, MASK_WORDS(count) * sizeof(*mask));
+
+    for (index = 0; index < count; index++)
+        mask[index / MASK_BITS] |= (uint64_t) ((column[index] >= min)
+            & (column[index] <= max)) << (index % MASK_BITS);
+}
+
+
+static void selectIntScalar(const int *column, int count, int min, int max,
+        uint64_t *mask)
+{
+    int index;
+
+    memset(mask, 0, MASK_WORDS(count) * sizeof(*mask));
+
+    for (index = 0; index < count; index++)
+        mask[index / MASK_BITS] |= (uint64_t) ((column[index] >= min)
+            & (column[index] <= max)) << (index % MASK_BITS);
+}
+
+
+static void selectTypeScalar(const int *info, int count, int type,
+        uint64_t *mask)
+{
+    int index;
+
+    memset(mask, 0, MASK_WORDS(count) * sizeof(*mask));
+
+    for (index = 0; index < count; index++)
+        mask[index / MASK_BITS] |= (uint64_t) ((info[index] & 1) == type)
+            << (index % MASK_BITS);
+}
+
+
+static void sumSelectedScalar(const long *amount, const int *info, int count,
+        const uint64_t *mask, long *income, long *expense)
+{
+    uint64_t bits;
+    long select, type;
+    int word, row, rows;
+
+    for (word = 0; word < MASK_WORDS(count); word++) {
+        bits = (mask != NULL) ? mask[word] : ALL_ROWS;
+        rows = rowsOfWord(count, word);
+
+        for (row = 0; row < rows; row++) {
+            select  = -(long) ((bits >> row) & 1);
+            type    = -(long) (info[row] & 1);
+
+            *income     += amount[row] & select & type;
+            *expense    += amount[row] & select & ~type;
+        }
+
+        amount  += MASK_BITS;
+        info    += MASK_BITS;
+    }
+}
+
+
+#ifdef SCAN_KERNEL_X86
+
+/*
+ * SSE4.2 kernels, 2 amounts or 4 dates are compared at a time
+ */
+__attribute__((target("sse4.2")))
+static void selectLongSse4(const long *column, int count, long min, long max,
+        uint64_t *mask)
+{
+    const __m128i low   = _mm_set1_epi64x(min);
+    const __m128i high  = _mm_set1_epi64x(max);
+    __m128i value, outside;
+    uint64_t bits;
+    int word, row, rows;
+
+    for (word = 0; word < MASK_WORDS(count); word++) {
+        rows = rowsOfWord(count, word);
+        bits = 0;
+
+        for (row = 0; row + 2 <= rows; row += 2) {
+            value   = _mm_loadu_si128((const __m128i *) &column[row]);
+            outside = _mm_or_si128(_mm_cmpgt_epi64(low, value),
+                _mm_cmpgt_epi64(value, high));
+            bits   |= (uint64_t) (~_mm_movemask_pd(_mm_castsi128_pd(outside))
+                & 0x3) << row;
+        }
+
+        for (; row < rows; row++)
+            bits |= (uint64_t) ((column[row] >= min) & (column[row] <= max))
+                << row;
+
+        mask[word] = bits;
+        column += MASK_BITS;
+    }
+}
+
+
+__attribute__((target("sse4.2")))
+static void selectIntSse4(const int *column, int count, int min, int max,
+        uint64_t *mask)
+{
+    const __m128i low   = _mm_set1_epi32(min);
+    const __m128i high  = _mm_set1_epi32(max);
+    __m128i value, outside;
+    uint64_t bits;
+    int word, row, rows;
+
+    for (word = 0; word < MASK_WORDS(count); word++) {
+        rows = rowsOfWord(count, word);
+        bits = 0;
+
+        for (row = 0; row + 4 <= rows; row += 4) {
+            value   = _mm_loadu_si128((const __m128i *) &column[row]);
+            outside = _mm_or_si128(_mm_cmplt_epi32(value, low),
+                _mm_cmpgt_epi32(value, high));
+            bits   |= (uint64_t) (~_mm_movemask_ps(_mm_castsi128_ps(outside))
+                & 0xF) << row;
+        }
+
+        for (; row < rows; row++)
+            bits |= (uint64_t) ((column[row] >= min) & (column[row] <= max))
+                << row;
+
+        mask[word] = bits;
+        column += MASK_BITS;
+    }
+}
+
+
+__attribute__((target("sse4.2")))
+static void selectTypeSse4(const int *info, int count, int type,
+        uint64_t *mask)
+{
+    const __m128i one       = _mm_set1_epi32(1);
+    const __m128i wanted    = _mm_set1_epi32(type);
+    __m128i value;
+    uint64_t bits;
+    int word, row, rows;
+
+    for (word = 0; word < MASK_WORDS(count); word++) {
+        rows = rowsOfWord(count, word);
+        bits = 0;
+
+        for (row = 0; row + 4 <= rows; row += 4) {
+            value   = _mm_loadu_si128((const __m128i *) &info[row]);
+            value   = _mm_cmpeq_epi32(_mm_and_si128(value, one), wanted);
+            bits   |= (uint64_t) _mm_movemask_ps(_mm_castsi128_ps(value)) << row;
+        }
+
+        for (; row < rows; row++)
+            bits |= (uint64_t) ((info[row] & 1) == type) << row;
+
+        mask[word] = bits;
+        info += MASK_BITS;
+    }
+}
+
+
+__attribute__((target("sse4.2")))
+static void sumSelectedSse4(const long *amount, const int *info, int count,
+        const uint64_t *mask, long *income, long *expense)
+{
+    const __m128i one   = _mm_set1_epi64x(1);
+    const __m128i lane  = _mm_set_epi64x(2, 1);
+    __m128i in_sum      = _mm_setzero_si128();
+    __m128i ex_sum      = _mm_setzero_si128();
+    __m128i value, type, select;
+    long sum[2];
+    uint64_t bits;
+    long select_row, type_row;
+    int word, row, rows;
+
+    for (word = 0; word < MASK_WORDS(count); word++) {
+        bits = (mask != NULL) ? mask[word] : ALL_ROWS;
+        rows = rowsOfWord(count, word);
+
+        for (row = 0; row + 2 <= rows; row += 2) {
+            value   = _mm_loadu_si128((const __m128i *) &amount[row]);
+            type    = _mm_cvtepi32_epi64(_mm_loadl_epi64(
+                        (const __m128i *) &info[row]));
+            type    = _mm_cmpeq_epi64(_mm_and_si128(type, one), one);
+            select  = _mm_and_si128(_mm_set1_epi64x((bits >> row) & 0x3), lane);
+            select  = _mm_cmpeq_epi64(select, lane);
+            value   = _mm_and_si128(value, select);
+
+            in_sum  = _mm_add_epi64(in_sum, _mm_and_si128(value, type));
+            ex_sum  = _mm_add_epi64(ex_sum, _mm_andnot_si128(type, value));
+        }
+
+        for (; row < rows; row++) {
+            select_row  = -(long) ((bits >> row) & 1);
+            type_row    = -(long) (info[row] & 1);
+
+            *income     += amount[row] & select_row & type_row;
+            *expense    += amount[row] & select_row & ~type_row;
+        }
+
+        amount  += MASK_BITS;
+        info    += MASK_BITS;
+    }
+
+    _mm_storeu_si128((__m128i *) sum, in_sum);
+    *income += sum[0] + sum[1];
+
+    _mm_storeu_si128((__m128i *) sum, ex_sum);
+    *expense += sum[0] + sum[1];
+}
+
+
+/*
+ * AVX2 kernels, 4 amounts or 8 dates are compared at a time
+ */
+__attribute__((target("avx2")))
+static void selectLongAvx2(const long *column, int count, long min, long max,
+        uint64_t *mask)
+{
+    const __m256i low   = _mm256_set1_epi64x(min);
+    const __m256i high  = _mm256_set1_epi64x(max);
+    __m256i value, outside;
+    uint64_t bits;
+    int word, row, rows;
+
+    for (word = 0; word < MASK_WORDS(count); word++) {
+        rows = rowsOfWord(count, word);
+        bits = 0;
+
+        for (row = 0; row + 4 <= rows; row += 4) {
+            value   = _mm256_loadu_si256((const __m256i *) &column[row]);
+            outside = _mm256_or_si256(_mm256_cmpgt_epi64(low, value),
+                _mm256_cmpgt_epi64(value, high));
+            bits   |= (uint64_t) (~_mm256_movemask_pd(
+                        _mm256_castsi256_pd(outside)) & 0xF) << row;
+        }
+
+        for (; row < rows; row++)
+            bits |= (uint64_t) ((column[row] >= min) & (column[row] <= max))
+                << row;
+
+        mask[word] = bits;
+        column += MASK_BITS;
+    }
+}
+
+
+__attribute__((target("avx2")))
+static void selectIntAvx2(const int *column, int count, int min, int max,
+        uint64_t *mask)
+{
+    const __m256i low   = _mm256_set1_epi32(min);
+    const __m256i high  = _mm256_set1_epi32(max);
+    __m256i value, outside;
+    uint64_t bits;
+    int word, row, rows;
+
+    for (word = 0; word < MASK_WORDS(count); word++) {
+        rows = rowsOfWord(count, word);
+        bits = 0;
+
+        for (row = 0; row + 8 <= rows; row += 8) {
+            value   = _mm256_loadu_si256((const __m256i *) &column[row]);
+            outside = _mm256_or_si256(_mm256_cmpgt_epi32(low, value),
+                _mm256_cmpgt_epi32(value, high));
+            bits   |= (uint64_t) (~_mm256_movemask_ps(
+                        _mm256_castsi256_ps(outside)) & 0xFF) << row;
+        }
+
+        for (; row < rows; row++)
+            bits |= (uint64_t) ((column[row] >= min) & (column[row] <= max))
+                << row;
+
+        mask[word] = bits;
+        column += MASK_BITS;
+    }
+}
+
+
+__attribute__((target("avx2")))
+static void selectTypeAvx2(const int *info, int count, int type,
+        uint64_t *mask)
+{
+    const __m256i one       = _mm256_set1_epi32(1);
+    const __m256i wanted    = _mm256_set1_epi32(type);
+    __m256i value;
+    uint64_t bits;
+    int word, row, rows;
+
+    for (word = 0; word < MASK_WORDS(count); word++) {
+        rows = rowsOfWord(count, word);
+        bits = 0;
+
+        for (row = 0; row + 8 <= rows; row += 8) {
+            value   = _mm256_loadu_si256((const __m256i *) &info[row]);
+            value   = _mm256_cmpeq_epi32(_mm256_and_si256(value, one), wanted);
+            bits   |= (uint64_t) _mm256_movemask_ps(
+                        _mm256_castsi256_ps(value)) << row;
+        }
+
+        for (; row < rows; row++)
+            bits |= (uint64_t) ((info[row] & 1) == type) << row;
+
+        mask[word] = bits;
+        info += MASK_BITS;
+    }
+}
+
+
+__attribute__((target("avx2")))
+static void sumSelectedAvx2(const long *amount, const int *info, int count,
+        const uint64_t *mask, long *income, long *expense)
+{
+    const __m256i one   = _mm256_set1_epi64x(1);
+    const __m256i lane  = _mm256_set_epi64x(8, 4, 2, 1);
+    __m256i in_sum      = _mm256_setzero_si256();
+    __m256i ex_sum      = _mm256_setzero_si256();
+    __m256i value, type, select;
+    long sum[4];
+    uint64_t bits;
+    long select_row, type_row;
+    int word, row, rows;
+
+    for (word = 0; word < MASK_WORDS(count); word++) {
+        bits = (mask != NULL) ? mask[word] : ALL_ROWS;
+        rows = rowsOfWord(count, word);
+
+        for (row = 0; row + 4 <= rows; row += 4) {
+            value   = _mm256_loadu_si256((const __m256i *) &amount[row]);
+            type    = _mm256_cvtepi32_epi64(_mm_loadu_si128(
+                        (const __m128i *) &info[row]));
+            type    = _mm256_cmpeq_epi64(_mm256_and_si256(type, one), one);
+            select  = _mm256_and_si256(_mm256_set1_epi64x((bits >> row) & 0xF),
+                        lane);
+            select  = _mm256_cmpeq_epi64(select, lane);
+            value   = _mm256_and_si256(value, select);
+
+            in_sum  = _mm256_add_epi64(in_sum, _mm256_and_si256(value, type));
+            ex_sum  = _mm256_add_epi64(ex_sum, _mm256_andnot_si256(type, value));
+        }
+
+        for (; row < rows; row++) {
+            select_row  = -(long) ((bits >> row) & 1);
+            type_row    = -(long) (info[row] & 1);
+
+            *income     += amount[row] & select_row & type_row;
+            *expense    += amount[row] & select_row & ~type_row;
+        }
+
+        amount  += MASK_BITS;
+        info    += MASK_BITS;
+    }
+
+    _mm256_storeu_si256((__m256i *) sum, in_sum);
+    *income += sum[0] + sum[1] + sum[2] + sum[3];
+
+    _mm256_storeu_si256((__m256i *) sum, ex_sum);
+    *expense += sum[0] + sum[1] + sum[2] + sum[3];
+}
+
+#endif
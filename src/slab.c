@@ -0,0 +1,117 @@
+/*
+ * slab.c
+ *
+ * Allocator of fixed size objects (slab), freed in bulk
+ *
+ *  Created on: 16-Oct-2026
+ *      Author: deepaks
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "headers/slab.h"
+#include "headers/customError.h"
+
+/* objects are aligned for any type */
+#define SLAB_ALIGN          16
+#define ALIGN_SLAB(x)       (((x) + SLAB_ALIGN - 1) & ~((size_t) SLAB_ALIGN - 1))
+
+/* chunk starts with the link to the previous chunk */
+#define CHUNK_HEADER_SIZE   ALIGN_SLAB(sizeof(void *))
+
+
+/*
+ * To initialize an empty slab for objects of given size
+ */
+void initSlab(Slab *slab, size_t size, int per_chunk)
+{
+    if (slab == NULL)
+        return;
+
+    memset(slab, 0, sizeof(*slab));
+
+    /* freed object holds the link of the free list */
+    if (size < sizeof(void *))
+        size = sizeof(void *);
+
+    slab->size      = ALIGN_SLAB(size);
+    slab->per_chunk = (per_chunk > 0) ? per_chunk : 1;
+}
+
+
+/*
+ * To free all the chunks of the slab (every object allocated from it)
+ */
+void destroySlab(Slab *slab)
+{
+    void *chunk;
+
+    if (slab == NULL)
+        return;
+
+    while (slab->chunk != NULL) {
+        chunk       = slab->chunk;
+        slab->chunk = *(void **) chunk;
+        free(chunk);
+    }
+
+    slab->next      = NULL;
+    slab->end       = NULL;
+    slab->free_list = NULL;
+}
+
+
+/*
+ * Function to allocate an object (not initialized)
+ * freed object is reused first, else taken from the latest chunk
+ *
+ * Returns NULL, if memory is not available
+ */
+void *allocSlab(Slab *slab)
+{
+    void *object;
+    char *chunk;
+
+    if (slab == NULL || slab->size == 0) {
+        logError(ERROR_FUNC_ARG);
+        return NULL;
+    }
+
+    if (slab->free_list != NULL) {
+        object          = slab->free_list;
+        slab->free_list = *(void **) object;
+        return object;
+    }
+
+    if (slab->next == slab->end) {
+        chunk = malloc(CHUNK_HEADER_SIZE + slab->size * slab->per_chunk);
+        if (chunk == NULL) {
+            logError(ERROR_MEMORY_ALLOC);
+            return NULL;
+        }
+
+        *(void **) chunk    = slab->chunk;
+        slab->chunk         = chunk;
+        slab->next          = chunk + CHUNK_HEADER_SIZE;
+        slab->end           = slab->next + slab->size * slab->per_chunk;
+    }
+
+    object      = slab->next;
+    slab->next += slab->size;
+
+    return object;
+}
+
+
+/*
+ * Function to give back the object into the slab, for reuse
+ */
+void freeSlab(Slab *slab, void *object)
+{
+    if (slab == NULL || object == NULL)
+        return;
+
+    *(void **) object   = slab->free_list;
+    slab->free_list     = object;
+}
@@ -0,0 +1,514 @@
+/*
+ * textIndex.c
+ *
+ * Inverted index from the trigrams (3 characters) of entity and comment
+ * into the sorted ids of the records (open addressing with linear probing)
+ *
+ * A text is searched by intersecting the ids of all its trigrams,
+ * so the result is a superset (records should be checked for the text)
+ *
+ *  Created on: 16-Oct-2026
+ *      Author: deepaks
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "headers/textIndex.h"
+#include "headers/customError.h"
+
+#define MIN_CAPACITY    1024
+#define MIN_POSTING     4
+
+/* trigrams of a text beyond this are not used */
+#define MAX_KEYS        256
+
+#define TEXT_KEY(field, text) \
+    ((unsigned int) (field) << 24 | (unsigned int) (unsigned char) (text)[0] << 16 \
+        | (unsigned int) (unsigned char) (text)[1] << 8 \
+        | (unsigned int) (unsigned char) (text)[2])
+
+/* Fibonacci hashing, capacity is always a power of 2 */
+#define HASH_KEY(key, capacity) \
+    ((int) (((key) * 2654435769u) & (unsigned int) ((capacity) - 1)))
+
+
+static int applyText(TextIndex *index, int id, int field, const char *text,
+        int add);
+static int textKeys(const char *text, int field, unsigned int *key);
+static int compareKey(const void *a, const void *b);
+static TextPosting *findPosting(const TextIndex *index, unsigned int key);
+static TextPosting *getPosting(TextIndex *index, unsigned int key);
+static int resizeTextIndex(TextIndex *index, int capacity);
+static int insertPostingId(TextPosting *posting, int id);
+static void removePostingId(TextPosting *posting, int id);
+static int hasPostingId(const TextPosting *posting, int id);
+static int searchField(const TextIndex *index, const unsigned int *key,
+        int no_of_key, int field, int **ids, int *count);
+static int mergeIds(int **ids, int *count, int *other, int other_count);
+
+
+/*
+ * To initialize an empty index
+ */
+void initTextIndex(TextIndex *index)
+{
+    if (index == NULL)
+        return;
+
+    memset(index, 0, sizeof(*index));
+}
+
+
+/*
+ * To free the index
+ */
+void freeTextIndex(TextIndex *index)
+{
+    int pos;
+
+    if (index == NULL)
+        return;
+
+    for (pos = 0; pos < index->capacity; pos++)
+        free(index->slot[pos].id);
+
+    free(index->slot);
+    initTextIndex(index);
+}
+
+
+/*
+ * Function to add the trigrams of entity and comment of the record
+ *
+ * Return = 0, indicates success
+ * Return < 0, indicates error (index is partly updated)
+ */
+int addTextIndex(TextIndex *index, int id, const char *entity,
+        const char *comment)
+{
+    if (index == NULL || entity == NULL || comment == NULL) {
+        logError(ERROR_FUNC_ARG);
+        return -2;
+    }
+
+    if (applyText(index, id, TEXT_ENTITY, entity, 1) != 0
+            || applyText(index, id, TEXT_COMMENT, comment, 1) != 0)
+        return -1;
+
+    return 0;
+}
+
+
+/*
+ * Function to remove the trigrams of entity and comment of the record
+ * (the same entity and comment, which were added)
+ */
+int removeTextIndex(TextIndex *index, int id, const char *entity,
+        const char *comment)
+{
+    if (index == NULL || entity == NULL || comment == NULL) {
+        logError(ERROR_FUNC_ARG);
+        return -2;
+    }
+
+    applyText(index, id, TEXT_ENTITY, entity, 0);
+    applyText(index, id, TEXT_COMMENT, comment, 0);
+
+    return 0;
+}
+
+
+/*
+ * Function to get the sorted ids of the records, which may contain the text
+ * in any of the fields (TEXT_ENTITY and / or TEXT_COMMENT)
+ * ids are allocated, and should be freed by the caller
+ *
+ * Return = 0, indicates success
+ * Return > 0, indicates text is shorter than a trigram
+ * Return < 0, indicates error
+ */
+int searchTextIndex(const TextIndex *index, const char *text, int fields,
+        int **ids, int *count)
+{
+    unsigned int key[MAX_KEYS];
+    int no_of_key;
+    int *field_ids;
+    int field_count;
+    int field;
+
+    if (index == NULL || text == NULL || ids == NULL || count == NULL) {
+        logError(ERROR_FUNC_ARG);
+        return -2;
+    }
+
+    *ids    = NULL;
+    *count  = 0;
+
+    /* keys are made without field, field is added while searching */
+    no_of_key = textKeys(text, 0, key);
+    if (no_of_key == 0)
+        return 1;
+
+    for (field = TEXT_ENTITY; field <= TEXT_COMMENT; field++) {
+        if ((fields & field) == 0)
+            continue;
+
+        if (searchField(index, key, no_of_key, field, &field_ids, &field_count) != 0
+                || mergeIds(ids, count, field_ids, field_count) != 0) {
+            free(*ids);
+            *ids    = NULL;
+            *count  = 0;
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+
+/*
+ * Function to add (or remove) the id into the posting of every trigram
+ */
+static int applyText(TextIndex *index, int id, int field, const char *text,
+        int add)
+{
+    unsigned int key[MAX_KEYS];
+    TextPosting *posting;
+    int no_of_key, i;
+
+    no_of_key = textKeys(text, field, key);
+
+    for (i = 0; i < no_of_key; i++) {
+        if (add) {
+            posting = getPosting(index, key[i]);
+            if (posting == NULL || insertPostingId(posting, id) != 0)
+                return -1;
+        } else {
+            posting = findPosting(index, key[i]);
+            if (posting != NULL)
+                removePostingId(posting, id);
+        }
+    }
+
+    return 0;
+}
+
+
+/*
+ * Function to get the sorted and unique trigram keys of the text
+ */
+static int textKeys(const char *text, int field, unsigned int *key)
+{
+    int count = 0;
+    int i, unique;
+
+    while (count < MAX_KEYS && text[0] != '\0' && text[1] != '\0'
+            && text[2] != '\0') {
+        key[count++] = TEXT_KEY(field, text);
+        text++;
+    }
+
+    if (count < 2)
+        return count;
+
+    qsort(key, count, sizeof(*key), compareKey);
+
+    for (i = 1, unique = 1; i < count; i++) {
+        if (key[i] != key[unique - 1])
+            key[unique++] = key[i];
+    }
+
+    return unique;
+}
+
+
+static int compareKey(const void *a, const void *b)
+{
+    unsigned int x = *(const unsigned int *) a;
+    unsigned int y = *(const unsigned int *) b;
+
+    return (x > y) - (x < y);
+}
+
+
+/*
+ * Function to find the posting of the key
+ *
+ * Returns NULL, if key is not present
+ */
+static TextPosting *findPosting(const TextIndex *index, unsigned int key)
+{
+    int pos;
+
+    if (index->capacity == 0)
+        return NULL;
+
+    pos = HASH_KEY(key, index->capacity);
+
+    while (index->slot[pos].key != 0) {
+        if (index->slot[pos].key == key)
+            return &index->slot[pos];
+
+        pos = (pos + 1) & (index->capacity - 1);
+    }
+
+    return NULL;
+}
+
+
+/*
+ * Function to find the posting of the key, added if not present
+ * (postings are not removed, even after their last id is removed)
+ */
+static TextPosting *getPosting(TextIndex *index, unsigned int key)
+{
+    TextPosting *posting;
+    int pos;
+
+    posting = findPosting(index, key);
+    if (posting != NULL)
+        return posting;
+
+    /* keep the load factor below 0.5, so that probes are short */
+    if ((index->count + 1) * 2 > index->capacity) {
+        if (resizeTextIndex(index, (index->capacity > 0)
+                ? index->capacity * 2 : MIN_CAPACITY) != 0)
+            return NULL;
+    }
+
+    pos = HASH_KEY(key, index->capacity);
+
+    while (index->slot[pos].key != 0)
+        pos = (pos + 1) & (index->capacity - 1);
+
+    index->slot[pos].key = key;
+    index->count++;
+
+    return &index->slot[pos];
+}
+
+
+/*
+ * Function to rehash all the postings into a new table of given capacity
+ */
+static int resizeTextIndex(TextIndex *index, int capacity)
+{
+    TextPosting *old_slot = index->slot;
+    int old_capacity = index->capacity;
+    int pos, index_pos;
+
+    index->slot = calloc(capacity, sizeof(*index->slot));
+    if (index->slot == NULL) {
+        index->slot = old_slot;
+        logError(ERROR_MEMORY_ALLOC);
+        return -1;
+    }
+
+    index->capacity = capacity;
+
+    for (pos = 0; pos < old_capacity; pos++) {
+        if (old_slot[pos].key == 0)
+            continue;
+
+        index_pos = HASH_KEY(old_slot[pos].key, capacity);
+
+        while (index->slot[index_pos].key != 0)
+            index_pos = (index_pos + 1) & (capacity - 1);
+
+        index->slot[index_pos] = old_slot[pos];
+    }
+
+    free(old_slot);
+
+    return 0;
+}
+
+
+/*
+ * Function to insert the id into the posting (kept sorted)
+ * ids of new records are the largest, so they are just appended
+ */
+static int insertPostingId(TextPosting *posting, int id)
+{
+    int *ids;
+    int low = 0;
+    int high, mid, capacity;
+
+    if (posting->count == posting->capacity) {
+        capacity = (posting->capacity > 0) ? posting->capacity * 2 : MIN_POSTING;
+
+        ids = realloc(posting->id, capacity * sizeof(*ids));
+        if (ids == NULL) {
+            logError(ERROR_MEMORY_ALLOC);
+            return -1;
+        }
+
+        posting->id         = ids;
+        posting->capacity   = capacity;
+    }
+
+    if (posting->count == 0 || posting->id[posting->count - 1] < id) {
+        posting->id[posting->count++] = id;
+        return 0;
+    }
+
+    high = posting->count;
+
+    while (low < high) {
+        mid = low + (high - low) / 2;
+
+        if (posting->id[mid] < id) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    if (posting->id[low] == id)
+        return 0;
+
+    memmove(&posting->id[low + 1], &posting->id[low],
+        (posting->count - low) * sizeof(*posting->id));
+    posting->id[low] = id;
+    posting->count++;
+
+    return 0;
+}
+
+
+static void removePostingId(TextPosting *posting, int id)
+{
+    int low = 0;
+    int high = posting->count;
+    int mid;
+
+    while (low < high) {
+        mid = low + (high - low) / 2;
+
+        if (posting->id[mid] < id) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    if (low == posting->count || posting->id[low] != id)
+        return;
+
+    memmove(&posting->id[low], &posting->id[low + 1],
+        (posting->count - low - 1) * sizeof(*posting->id));
+    posting->count--;
+}
+
+
+static int hasPostingId(const TextPosting *posting, int id)
+{
+    int low = 0;
+    int high = posting->count;
+    int mid;
+
+    while (low < high) {
+        mid = low + (high - low) / 2;
+
+        if (posting->id[mid] < id) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    return low < posting->count && posting->id[low] == id;
+}
+
+
+/*
+ * Function to intersect the postings of all the trigrams of the field
+ * ids of the shortest posting are checked in the others (binary search),
+ * so the cost depends on the shortest posting, not on the no of records
+ */
+static int searchField(const TextIndex *index, const unsigned int *key,
+        int no_of_key, int field, int **ids, int *count)
+{
+    const TextPosting *posting[MAX_KEYS];
+    const TextPosting *shortest = NULL;
+    int i, j;
+
+    *ids    = NULL;
+    *count  = 0;
+
+    for (i = 0; i < no_of_key; i++) {
+        posting[i] = findPosting(index, key[i] | (unsigned int) field << 24);
+
+        /* a trigram without any record, so no record has the text */
+        if (posting[i] == NULL || posting[i]->count == 0)
+            return 0;
+
+        if (shortest == NULL || posting[i]->count < shortest->count)
+            shortest = posting[i];
+    }
+
+    *ids = malloc(shortest->count * sizeof(**ids));
+    if (*ids == NULL) {
+        logError(ERROR_MEMORY_ALLOC);
+        return -1;
+    }
+
+    for (j = 0; j < shortest->count; j++) {
+        for (i = 0; i < no_of_key; i++) {
+            if (posting[i] != shortest && !hasPostingId(posting[i], shortest->id[j]))
+                break;
+        }
+
+        if (i == no_of_key)
+            (*ids)[(*count)++] = shortest->id[j];
+    }
+
+    return 0;
+}
+
+
+/*
+ * Function to merge the sorted ids of other into ids (union)
+ * other is freed
+ */
+static int mergeIds(int **ids, int *count, int *other, int other_count)
+{
+    int *merged;
+    int i = 0, j = 0, k = 0;
+
+    if (*ids == NULL) {
+        *ids    = other;
+        *count  = other_count;
+        return 0;
+    }
+
+    if (other == NULL)
+        return 0;
+
+    merged = malloc((*count + other_count) * sizeof(*merged));
+    if (merged == NULL) {
+        logError(ERROR_MEMORY_ALLOC);
+        free(other);
+        return -1;
+    }
+
+    while (i < *count || j < other_count) {
+        if (j == other_count || (i < *count && (*ids)[i] < other[j])) {
+            merged[k++] = (*ids)[i++];
+        } else if (i == *count || other[j] < (*ids)[i]) {
+            merged[k++] = other[j++];
+        } else {
+            merged[k++] = (*ids)[i++];
+            j++;
+        }
+    }
+
+    free(*ids);
+    free(other);
+
+    *ids    = merged;
+    *count  = k;
+
+    return 0;
+}
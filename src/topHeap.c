@@ -0,0 +1,145 @@
+/*
+ * topHeap.c
+ *
+ * Bounded min heap to keep the k largest records (by amount) of a scan,
+ * O(log k) for every record larger than the smallest kept, O(k) memory
+ *
+ *  Created on: 16-Oct-2026
+ *      Author: deepaks
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "headers/topHeap.h"
+#include "headers/customError.h"
+
+/* entry a is smaller than entry b (later record is larger for same amount) */
+#define ENTRY_LESS(a, b) \
+    ((a)->amount < (b)->amount || ((a)->amount == (b)->amount && (a)->id < (b)->id))
+
+
+static void siftUp(TopEntry *entry, int pos);
+static void siftDown(TopEntry *entry, int count, int pos);
+
+
+/*
+ * To initialize an empty heap for k records
+ *
+ * Return = 0, indicates success
+ * Return < 0, indicates error
+ */
+int initTopHeap(TopHeap *heap, int k)
+{
+    if (heap == NULL || k <= 0) {
+        logError(ERROR_FUNC_ARG);
+        return -2;
+    }
+
+    memset(heap, 0, sizeof(*heap));
+
+    heap->entry = malloc(k * sizeof(*heap->entry));
+    if (heap->entry == NULL) {
+        logError(ERROR_MEMORY_ALLOC);
+        return -1;
+    }
+
+    heap->k = k;
+
+    return 0;
+}
+
+
+/*
+ * To free the entries of the heap
+ */
+void freeTopHeap(TopHeap *heap)
+{
+    if (heap == NULL)
+        return;
+
+    free(heap->entry);
+    memset(heap, 0, sizeof(*heap));
+}
+
+
+/*
+ * Function to push the record into heap, if it is one of the k largest
+ * (the smallest record is dropped, when heap is full)
+ */
+void pushTopHeap(TopHeap *heap, const TopEntry *entry)
+{
+    if (heap->count < heap->k) {
+        heap->entry[heap->count] = *entry;
+        siftUp(heap->entry, heap->count++);
+        return;
+    }
+
+    if (!ENTRY_LESS(&heap->entry[0], entry))
+        return;
+
+    heap->entry[0] = *entry;
+    siftDown(heap->entry, heap->count, 0);
+}
+
+
+/*
+ * Function to sort the entries from the largest record (heap sort)
+ * no more records can be pushed after this
+ */
+void sortTopHeap(TopHeap *heap)
+{
+    TopEntry smallest;
+    int count;
+
+    if (heap == NULL)
+        return;
+
+    /* smallest entry is moved to the end, till the heap is empty */
+    for (count = heap->count; count > 1; count--) {
+        smallest                = heap->entry[0];
+        heap->entry[0]          = heap->entry[count - 1];
+        heap->entry[count - 1]  = smallest;
+
+        siftDown(heap->entry, count - 1, 0);
+    }
+}
+
+
+static void siftUp(TopEntry *entry, int pos)
+{
+    TopEntry moving = entry[pos];
+    int parent;
+
+    while (pos > 0) {
+        parent = (pos - 1) / 2;
+
+        if (!ENTRY_LESS(&moving, &entry[parent]))
+            break;
+
+        entry[pos] = entry[parent];
+        pos = parent;
+    }
+
+    entry[pos] = moving;
+}
+
+
+static void siftDown(TopEntry *entry, int count, int pos)
+{
+    TopEntry moving = entry[pos];
+    int child;
+
+    while ((child = 2 * pos + 1) < count) {
+        if (child + 1 < count && ENTRY_LESS(&entry[child + 1], &entry[child]))
+            child++;
+
+        if (!ENTRY_LESS(&entry[child], &moving))
+            break;
+
+        entry[pos] = entry[child];
+        pos = child;
+    }
+
+    entry[pos] = moving;
+}
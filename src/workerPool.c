@@ -0,0 +1,218 @@
+/*
+ * workerPool.c
+ *
+ * Pool of worker threads to run the tasks of a scan in parallel,
+ * the thread calling runWorkerPool also works on the tasks
+ *
+ * Workers are started on the first run, and wait for the next run after that
+ * pool is used only by the main thread (one run at a time)
+ *
+ *  Created on: 16-Oct-2026
+ *      Author: deepaks
+ */
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "headers/workerPool.h"
+#include "headers/customError.h"
+
+/* no of threads, if it is not set (at most one per cpu) */
+#define DEFAULT_THREADS     8
+
+
+struct workerPool {
+    pthread_t       thread[MAX_POOL_THREADS];
+    int             threads;    /* no of threads including the caller */
+    int             started;    /* no of worker threads started */
+
+    pthread_mutex_t lock;
+    pthread_cond_t  start;      /* signalled for a new run or stop */
+    pthread_cond_t  finish;     /* signalled when the last worker is done */
+    unsigned long   run;        /* sequence no of the current run */
+    int             busy;       /* no of workers yet to finish the run */
+    int             stop;
+
+    /* tasks of the current run */
+    PoolTask        task;
+    void            *context;
+    int             count;
+    atomic_int      next;       /* next task to be taken */
+};
+
+
+static int startWorkers(void);
+static void *workerThread(void *argument);
+static void runTasks(void);
+
+
+static struct workerPool pool = {
+    .lock   = PTHREAD_MUTEX_INITIALIZER,
+    .start  = PTHREAD_COND_INITIALIZER,
+    .finish = PTHREAD_COND_INITIALIZER,
+};
+
+
+/*
+ * Function to set the no of threads used for a scan (1 for no workers)
+ * should be called before the first run
+ *
+ * Return = 0, indicates success
+ * Return > 0, indicates invalid no of threads
+ */
+int setPoolThreads(int threads)
+{
+    if (threads < 1 || threads > MAX_POOL_THREADS)
+        return 1;
+
+    destroyWorkerPool();
+    pool.threads = threads;
+
+    return 0;
+}
+
+
+/*
+ * Function to get the no of threads used for a scan
+ */
+int getPoolThreads(void)
+{
+    long cpus;
+
+    if (pool.threads == 0) {
+        cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        pool.threads = (cpus < 1) ? 1 : (cpus > DEFAULT_THREADS)
+            ? DEFAULT_THREADS : (int) cpus;
+    }
+
+    return pool.threads;
+}
+
+
+/*
+ * Function to run task(context, i) for every i from 0 till count - 1
+ * tasks are taken by the workers and the caller in order,
+ * returns after all the tasks are finished
+ *
+ * Return = 0, indicates success
+ * Return < 0, indicates error
+ */
+int runWorkerPool(PoolTask task, void *context, int count)
+{
+    if (task == NULL || count < 0) {
+        logError(ERROR_FUNC_ARG);
+        return -2;
+    }
+
+    pool.task       = task;
+    pool.context    = context;
+    pool.count      = count;
+    atomic_store(&pool.next, 0);
+
+    /* small runs (or failure to start the workers) are run by caller alone */
+    if (count < 2 || getPoolThreads() < 2 || startWorkers() != 0) {
+        runTasks();
+        return 0;
+    }
+
+    pthread_mutex_lock(&pool.lock);
+    pool.run++;
+    pool.busy = pool.started;
+    pthread_cond_broadcast(&pool.start);
+    pthread_mutex_unlock(&pool.lock);
+
+    runTasks();
+
+    pthread_mutex_lock(&pool.lock);
+    while (pool.busy > 0)
+        pthread_cond_wait(&pool.finish, &pool.lock);
+    pthread_mutex_unlock(&pool.lock);
+
+    return 0;
+}
+
+
+/*
+ * To stop and join the worker threads
+ */
+void destroyWorkerPool(void)
+{
+    int index;
+
+    if (pool.started == 0)
+        return;
+
+    pthread_mutex_lock(&pool.lock);
+    pool.stop = 1;
+    pthread_cond_broadcast(&pool.start);
+    pthread_mutex_unlock(&pool.lock);
+
+    for (index = 0; index < pool.started; index++)
+        pthread_join(pool.thread[index], NULL);
+
+    pool.started    = 0;
+    pool.stop       = 0;
+}
+
+
+/*
+ * Function to start the workers (threads - 1), if not started already
+ */
+static int startWorkers(void)
+{
+    while (pool.started < pool.threads - 1) {
+        if (pthread_create(&pool.thread[pool.started], NULL, workerThread,
+                (void *) pool.run) != 0) {
+            logError(ERROR_WENT_WRONG);
+            return (pool.started > 0) ? 0 : -1;
+        }
+
+        pool.started++;
+    }
+
+    return 0;
+}
+
+
+/*
+ * Worker waits for a run, takes tasks till none is left,
+ * and the last worker to finish wakes up the caller
+ */
+static void *workerThread(void *argument)
+{
+    unsigned long run = (unsigned long) argument;
+
+    pthread_mutex_lock(&pool.lock);
+
+    for (;;) {
+        while (pool.run == run && pool.stop == 0)
+            pthread_cond_wait(&pool.start, &pool.lock);
+
+        if (pool.stop)
+            break;
+
+        run = pool.run;
+        pthread_mutex_unlock(&pool.lock);
+
+        runTasks();
+
+        pthread_mutex_lock(&pool.lock);
+        if (--pool.busy == 0)
+            pthread_cond_signal(&pool.finish);
+    }
+
+    pthread_mutex_unlock(&pool.lock);
+
+    return NULL;
+}
+
+
+static void runTasks(void)
+{
+    int task;
+
+    while ((task = atomic_fetch_add(&pool.next, 1)) < pool.count)
+        pool.task(pool.context, task);
+}